@@ -9,12 +9,43 @@
 #define EVENT_CONTROLLER_H
 #include <Arduino.h>
 #include <Array.h>
-#include <TimerOne.h>
-#include <TimerThree.h>
 #include <Functor.h>
-#include <FunctorCallbacks.h>
+#include "EventController/EventId.h"
+
+#if !defined(EVENT_CONTROLLER_NO_RUNTIME_TIMER)
+#include "EventTimerRuntime.h"
+#else
+struct EventTimerRuntime;
+#endif
+
+#ifndef EVENT_POOL_OWNER_COUNT_MAX
+#define EVENT_POOL_OWNER_COUNT_MAX 4
+#endif
+
+#ifndef EVENT_CONTROLLER_DEFERRED_COUNT_MAX
+#define EVENT_CONTROLLER_DEFERRED_COUNT_MAX 16
+#endif
+
+#if defined(__cpp_impl_coroutine)
+#define EVENT_CONTROLLER_COROUTINES
+#include "EventTask.h"
+#endif
 
 
+#if defined(__AVR__)
+typedef uint8_t EventPortRegister;
+#else
+typedef uint32_t EventPortRegister;
+#endif
+
+enum EventAction
+{
+  EVENT_ACTION_FUNCTOR,
+  EVENT_ACTION_PIN_HIGH,
+  EVENT_ACTION_PIN_LOW,
+  EVENT_ACTION_PIN_TOGGLE,
+};
+
 struct Event
 {
   Functor1<int> functor;
@@ -23,48 +54,198 @@ struct Event
   bool free;
   bool enabled;
   bool infinite;
-  uint32_t period_ms;
+  union
+  {
+    uint32_t period;
+    uint32_t period_ms;
+  };
+  uint16_t period_remainder;
+  uint16_t period_denominator;
+  uint16_t phase;
   uint16_t count;
   uint16_t inc;
   int arg;
+  uint8_t groups;
+  uint8_t action;
+  volatile EventPortRegister * port_register;
+  EventPortRegister port_bit_mask;
+  uint8_t pin;
+  bool batched;
+  uint8_t batch_next;
+  volatile bool armed;
+  bool rearm;
+  uint32_t trigger_delay;
+  bool deferred;
+  uint8_t handler;
   Functor1<int> functor_start;
   Functor1<int> functor_stop;
 };
-struct EventId
+struct EventHandler
 {
-  uint8_t index;
-  uint32_t time_start;
-  EventId() :
-  index(255),
-  time_start(0) {}
+  Functor1<int> functor;
+  Functor1<int> functor_start;
+  Functor1<int> functor_stop;
+  uint16_t cost_us;
+  EventHandler() :
+  cost_us(0) {}
+};
+struct EventPeriod
+{
+  uint32_t numerator_ms;
+  uint16_t denominator;
+  explicit EventPeriod(uint32_t numerator_ms=0,
+    uint16_t denominator=1) :
+  numerator_ms(numerator_ms),
+  denominator(denominator) {}
+};
+struct EventSequenceRecord
+{
+  uint32_t delta_us;
+  int arg;
 };
-struct EventIdPair
+struct EventLoad
 {
-  EventId event_id_0;
-  EventId event_id_1;
-  EventIdPair() :
-  event_id_0(EventId()),
-  event_id_1(EventId()) {}
+  uint32_t horizon;
+  uint32_t tick_count;
+  uint32_t cost_average_us;
+  uint32_t cost_max_us;
+  uint32_t cost_max_tick;
+  uint8_t events_max;
+  uint32_t events_max_tick;
+  uint32_t overrun_count;
+  uint32_t overrun_first_tick;
+  uint8_t unknown_cost_count;
+  EventLoad() :
+  horizon(0),
+  tick_count(0),
+  cost_average_us(0),
+  cost_max_us(0),
+  cost_max_tick(0),
+  events_max(0),
+  events_max_tick(0),
+  overrun_count(0),
+  overrun_first_tick(0),
+  unknown_cost_count(0) {}
 };
 
 template <uint8_t EVENT_COUNT_MAX>
+class EventPool
+{
+public:
+  EventPool();
+  enum{OWNER_COUNT_MAX=EVENT_POOL_OWNER_COUNT_MAX};
+  enum{OWNER_NONE=255};
+  enum{EVENT_INDEX_NONE=255};
+  enum{HANDLER_NONE=255};
+  uint8_t addOwner();
+  void setQuota(uint8_t owner,
+    uint8_t quota);
+  uint8_t getQuota(uint8_t owner);
+  uint8_t getCount(uint8_t owner);
+  uint8_t getCount();
+  uint8_t getAvailable(uint8_t owner);
+  uint8_t getHighWatermark(uint8_t owner);
+  uint8_t getHighWatermark();
+  void resetHighWatermarks();
+  uint8_t allocate(uint8_t owner);
+  bool claim(uint8_t event_index,
+    uint8_t owner);
+  void deallocate(uint8_t event_index);
+  bool owns(uint8_t owner,
+    uint8_t event_index);
+  Array<Event,EVENT_COUNT_MAX> & getEventArray();
+private:
+  Array<Event,EVENT_COUNT_MAX> event_array_;
+  uint8_t owners_[EVENT_COUNT_MAX];
+  uint8_t free_next_[EVENT_COUNT_MAX];
+  uint8_t free_head_;
+  uint8_t count_;
+  uint8_t high_watermark_;
+  uint8_t owner_count_;
+  uint8_t quotas_[OWNER_COUNT_MAX];
+  uint8_t counts_[OWNER_COUNT_MAX];
+  uint8_t high_watermarks_[OWNER_COUNT_MAX];
+};
+
+template <uint8_t EVENT_COUNT_MAX, bool EVENT_POOL_SHARED>
+struct EventPoolStorage
+{
+  EventPool<EVENT_COUNT_MAX> event_pool;
+};
+template <uint8_t EVENT_COUNT_MAX>
+struct EventPoolStorage<EVENT_COUNT_MAX,true>
+{
+};
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US=1000, bool EVENT_POOL_SHARED=false, typename EVENT_TIMER=EventTimerRuntime>
 class EventController
 {
 public:
   EventController();
+  EventController(EventPool<EVENT_COUNT_MAX> & event_pool);
   enum{MICRO_SEC_PER_MILLI_SEC=1000};
+  enum{TICKS_PER_MILLI_SEC=MICRO_SEC_PER_MILLI_SEC/TICK_PERIOD_US};
+  enum{TICKS_DELAY_MAX=0x7FFFFFFF};
+  enum{SLEW_PERIOD_DEFAULT=100};
+  enum{EVENT_INDEX_NONE=EventPool<EVENT_COUNT_MAX>::EVENT_INDEX_NONE};
+  enum{HANDLER_NONE=EventPool<EVENT_COUNT_MAX>::HANDLER_NONE};
+  enum{HORIZON_MAX_DEFAULT=60000};
+  enum{SCHEDULE_MAGIC=0x4345};
+  enum{SCHEDULE_VERSION=2};
+  enum{SCHEDULE_HEADER_SIZE=6};
+  enum{SCHEDULE_RECORD_SIZE=40};
+  enum{SCHEDULE_RECORD_DATA_SIZE=38};
+  enum{SCHEDULE_CRC_SIZE=2};
+  enum{SCHEDULE_CRC_POLYNOMIAL=0x1021};
+  enum{PIN_NONE=255};
+  enum CommandOp
+  {
+    COMMAND_ADD=1,
+    COMMAND_MODIFY,
+    COMMAND_ENABLE,
+    COMMAND_DISABLE,
+    COMMAND_REMOVE,
+  };
+  enum CommandStatus
+  {
+    COMMAND_OK,
+    COMMAND_INVALID_EVENT,
+    COMMAND_INVALID_HANDLER,
+    COMMAND_FULL,
+    COMMAND_INVALID_OP,
+    COMMAND_TRUNCATED,
+    COMMAND_INVALID_PERIOD,
+  };
+  enum{COMMAND_FRAME_HEADER_SIZE=2};
+  enum{COMMAND_ADD_SIZE=18};
+  enum{COMMAND_MODIFY_SIZE=10};
+  enum{COMMAND_EVENT_ID_SIZE=5};
+  enum{COMMAND_RESULT_SIZE_MAX=6};
+  enum{COMMAND_COUNT_INFINITE=0xFFFF};
   void setup(size_t timer_number=1);
   uint32_t getTime();
+  uint32_t getTicks();
   void setTime(uint32_t time=0);
+  void rebaseTime(uint32_t time);
+  void slewTime(uint32_t time,
+    uint16_t slew_period=SLEW_PERIOD_DEFAULT);
+  int32_t getSlewRemaining();
   EventId addEvent(const Functor1<int> & functor,
     int arg=-1);
   EventId addRecurringEvent(const Functor1<int> & functor,
     uint32_t period_ms,
     int32_t count,
     int arg=-1);
+  EventId addRecurringEvent(const Functor1<int> & functor,
+    const EventPeriod period,
+    int32_t count,
+    int arg=-1);
   EventId addInfiniteRecurringEvent(const Functor1<int> & functor,
     uint32_t period_ms,
     int arg=-1);
+  EventId addInfiniteRecurringEvent(const Functor1<int> & functor,
+    const EventPeriod period,
+    int arg=-1);
   EventId addEventUsingTime(const Functor1<int> & functor,
     uint32_t time,
     int arg=-1);
@@ -73,10 +254,19 @@ public:
     uint32_t period_ms,
     int32_t count,
     int arg=-1);
+  EventId addRecurringEventUsingTime(const Functor1<int> & functor,
+    uint32_t time,
+    const EventPeriod period,
+    int32_t count,
+    int arg=-1);
   EventId addInfiniteRecurringEventUsingTime(const Functor1<int> & functor,
     uint32_t time,
     uint32_t period_ms,
     int arg=-1);
+  EventId addInfiniteRecurringEventUsingTime(const Functor1<int> & functor,
+    uint32_t time,
+    const EventPeriod period,
+    int arg=-1);
   EventId addEventUsingDelay(const Functor1<int> & functor,
     uint32_t delay,
     int arg=-1);
@@ -85,10 +275,19 @@ public:
     uint32_t period_ms,
     int32_t count,
     int arg=-1);
+  EventId addRecurringEventUsingDelay(const Functor1<int> & functor,
+    uint32_t delay,
+    const EventPeriod period,
+    int32_t count,
+    int arg=-1);
   EventId addInfiniteRecurringEventUsingDelay(const Functor1<int> & functor,
     uint32_t delay,
     uint32_t period_ms,
     int arg=-1);
+  EventId addInfiniteRecurringEventUsingDelay(const Functor1<int> & functor,
+    uint32_t delay,
+    const EventPeriod period,
+    int arg=-1);
   EventId addEventUsingOffset(const Functor1<int> & functor,
     const EventId event_id_origin,
     uint32_t offset,
@@ -99,11 +298,22 @@ public:
     uint32_t period_ms,
     int32_t count,
     int arg=-1);
+  EventId addRecurringEventUsingOffset(const Functor1<int> & functor,
+    const EventId event_id_origin,
+    uint32_t offset,
+    const EventPeriod period,
+    int32_t count,
+    int arg=-1);
   EventId addInfiniteRecurringEventUsingOffset(const Functor1<int> & functor,
     const EventId event_id_origin,
     uint32_t offset,
     uint32_t period_ms,
     int arg=-1);
+  EventId addInfiniteRecurringEventUsingOffset(const Functor1<int> & functor,
+    const EventId event_id_origin,
+    uint32_t offset,
+    const EventPeriod period,
+    int arg=-1);
   EventIdPair addPwmUsingTime(const Functor1<int> & functor_0,
     const Functor1<int> & functor_1,
     uint32_t time,
@@ -111,6 +321,13 @@ public:
     uint32_t on_duration_ms,
     int32_t count,
     int arg=-1);
+  EventIdPair addPwmUsingTime(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t time,
+    const EventPeriod period,
+    uint32_t on_duration_ms,
+    int32_t count,
+    int arg=-1);
   EventIdPair addPwmUsingDelay(const Functor1<int> & functor_0,
     const Functor1<int> & functor_1,
     uint32_t delay,
@@ -118,6 +335,13 @@ public:
     uint32_t on_duration_ms,
     int32_t count,
     int arg=-1);
+  EventIdPair addPwmUsingDelay(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t delay,
+    const EventPeriod period,
+    uint32_t on_duration_ms,
+    int32_t count,
+    int arg=-1);
   EventIdPair addPwmUsingOffset(const Functor1<int> & functor_0,
     const Functor1<int> & functor_1,
     const EventId event_id_origin,
@@ -126,18 +350,38 @@ public:
     uint32_t on_duration_ms,
     int32_t count,
     int arg=-1);
+  EventIdPair addPwmUsingOffset(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    const EventId event_id_origin,
+    uint32_t offset,
+    const EventPeriod period,
+    uint32_t on_duration_ms,
+    int32_t count,
+    int arg=-1);
   EventIdPair addInfinitePwmUsingTime(const Functor1<int> & functor_0,
     const Functor1<int> & functor_1,
     uint32_t time,
     uint32_t period_ms,
     uint32_t on_duration_ms,
     int arg=-1);
+  EventIdPair addInfinitePwmUsingTime(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t time,
+    const EventPeriod period,
+    uint32_t on_duration_ms,
+    int arg=-1);
   EventIdPair addInfinitePwmUsingDelay(const Functor1<int> & functor_0,
     const Functor1<int> & functor_1,
     uint32_t delay,
     uint32_t period_ms,
     uint32_t on_duration_ms,
     int arg=-1);
+  EventIdPair addInfinitePwmUsingDelay(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t delay,
+    const EventPeriod period,
+    uint32_t on_duration_ms,
+    int arg=-1);
   EventIdPair addInfinitePwmUsingOffset(const Functor1<int> & functor_0,
     const Functor1<int> & functor_1,
     const EventId event_id_origin,
@@ -145,12 +389,55 @@ public:
     uint32_t period_ms,
     uint32_t on_duration_ms,
     int arg=-1);
+  EventIdPair addInfinitePwmUsingOffset(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    const EventId event_id_origin,
+    uint32_t offset,
+    const EventPeriod period,
+    uint32_t on_duration_ms,
+    int arg=-1);
+  EventId addEventUsingDelayMicros(const Functor1<int> & functor,
+    uint32_t delay_us,
+    int arg=-1);
+  EventId addRecurringEventUsingDelayMicros(const Functor1<int> & functor,
+    uint32_t delay_us,
+    uint32_t period_us,
+    int32_t count,
+    int arg=-1);
+  EventId addInfiniteRecurringEventUsingDelayMicros(const Functor1<int> & functor,
+    uint32_t delay_us,
+    uint32_t period_us,
+    int arg=-1);
+  EventIdPair addPwmUsingDelayMicros(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t delay_us,
+    uint32_t period_us,
+    uint32_t on_duration_us,
+    int32_t count,
+    int arg=-1);
+  EventIdPair addInfinitePwmUsingDelayMicros(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t delay_us,
+    uint32_t period_us,
+    uint32_t on_duration_us,
+    int arg=-1);
   void addStartFunctor(const EventId event_id,
     const Functor1<int> & functor);
   void addStopFunctor(const EventId event_id,
     const Functor1<int> & functor);
   void replaceFunctor(const EventId event_id,
     const Functor1<int> & functor);
+  void setPinAction(const EventId event_id,
+    size_t pin,
+    EventAction action);
+  void setPinActions(const EventIdPair event_id_pair,
+    size_t pin,
+    EventAction action_0=EVENT_ACTION_PIN_HIGH,
+    EventAction action_1=EVENT_ACTION_PIN_LOW);
+  void setRegisterAction(const EventId event_id,
+    volatile EventPortRegister * port_register,
+    EventPortRegister port_bit_mask,
+    EventAction action);
   void addStartFunctor(const EventIdPair event_id_pair,
     const Functor1<int> & functor);
   void addStopFunctor(const EventIdPair event_id_pair,
@@ -168,36 +455,287 @@ public:
   void enable(const EventIdPair event_id_pair);
   void disable(const EventId event_id);
   void disable(const EventIdPair event_id_pair);
+  void addToGroup(const EventId event_id,
+    uint8_t group_mask);
+  void addToGroup(const EventIdPair event_id_pair,
+    uint8_t group_mask);
+  void removeFromGroup(const EventId event_id,
+    uint8_t group_mask);
+  void removeFromGroup(const EventIdPair event_id_pair,
+    uint8_t group_mask);
+  void enableGroup(uint8_t group_mask);
+  void disableGroup(uint8_t group_mask);
+  void removeGroup(uint8_t group_mask);
+  void armUsingDelay(const EventId event_id,
+    uint32_t delay);
+  void armUsingDelay(const EventIdPair event_id_pair,
+    uint32_t delay);
+  void armUsingDelayMicros(const EventId event_id,
+    uint32_t delay_us);
+  void armUsingDelayMicros(const EventIdPair event_id_pair,
+    uint32_t delay_us);
+  void trigger(const EventId event_id);
+  void trigger(const EventIdPair event_id_pair);
+  EventId addTimeout(const Functor1<int> & functor,
+    uint32_t timeout,
+    int arg=-1);
+  EventId addTimeoutMicros(const Functor1<int> & functor,
+    uint32_t timeout_us,
+    int arg=-1);
+  void kick(const EventId event_id);
+  bool coalesce(const EventId event_id_leader,
+    const EventId event_id);
+  uint8_t coalesceAll();
+  void setDeferred(const EventId event_id,
+    bool deferred=true);
+  void setDeferred(const EventIdPair event_id_pair,
+    bool deferred=true);
+  uint8_t dispatchDeferred();
+  template <typename Dispatcher>
+  uint8_t dispatchDeferred(Dispatcher & dispatcher);
+  uint8_t deferredPending();
+  uint16_t getDeferredOverflowCount();
+  void setHandlerTable(EventHandler * handlers,
+    uint8_t handler_count);
+  void setHandler(const EventId event_id,
+    uint8_t handler);
+  void setHandlers(const EventIdPair event_id_pair,
+    uint8_t handler_0,
+    uint8_t handler_1);
+  size_t getScheduleSize();
+  size_t saveSchedule(uint8_t * buffer,
+    size_t buffer_size);
+  size_t saveSchedule(Stream & stream);
+  bool restoreSchedule(const uint8_t * buffer,
+    size_t buffer_size,
+    uint32_t elapsed=0);
+  bool restoreSchedule(Stream & stream,
+    uint32_t elapsed=0);
+  size_t processCommands(const uint8_t * frame,
+    size_t frame_size,
+    uint8_t * response,
+    size_t response_size);
+  void measureHandlerCosts(bool measure=true);
+  EventLoad analyzeLoad(uint32_t budget_us,
+    uint16_t overhead_us=0,
+    uint32_t horizon_max_ms=HORIZON_MAX_DEFAULT);
+#if defined(EVENT_CONTROLLER_COROUTINES)
+  EventTaskAwaiter<EventController> delay(uint32_t delay);
+  EventTaskAwaiter<EventController> delayMicros(uint32_t delay_us);
+  EventTaskAwaiter<EventController> until(uint32_t time);
+#endif
   Event getEvent(const EventId event_id);
   Event getEvent(uint8_t event_index);
   void setEventArgToEventIndex(const EventId event_id);
   uint8_t eventsActive();
   uint8_t eventsAvailable();
   Array<Event,EVENT_COUNT_MAX> getEventArray();
+  EventId addSequenceUsingDelay(const Functor1<int> & functor,
+    EventSequenceRecord * records,
+    uint8_t record_count_max,
+    uint32_t delay=0);
+  void setSequenceLowWatermark(uint8_t low_watermark,
+    const Functor1<int> & functor);
+  bool pushSequence(uint32_t delta_us,
+    int arg=-1);
+  uint8_t getSequenceSpace();
+  uint16_t getSequenceUnderrunCount();
+  uint32_t poll();
+  uint32_t getPollLagMax();
+  EventPool<EVENT_COUNT_MAX> & getEventPool();
+  void setQuota(uint8_t quota);
+  uint8_t getHighWatermark();
 private:
-  volatile uint32_t millis_;
-  Array<Event,EVENT_COUNT_MAX> event_array_;
+  static_assert((TICK_PERIOD_US > 0) && ((MICRO_SEC_PER_MILLI_SEC % TICK_PERIOD_US) == 0),
+    "TICK_PERIOD_US must divide one millisecond");
+  struct TickPeriod
+  {
+    uint32_t ticks;
+    uint16_t remainder;
+    uint16_t denominator;
+    TickPeriod() :
+    ticks(0),
+    remainder(0),
+    denominator(1) {}
+  };
+  volatile uint32_t ticks_;
+  volatile uint32_t ticks_epoch_;
+  volatile int32_t slew_remaining_;
+  uint16_t slew_period_;
+  uint16_t slew_count_;
+  EventPoolStorage<EVENT_COUNT_MAX,EVENT_POOL_SHARED> event_pool_storage_;
+  EventPool<EVENT_COUNT_MAX> & event_pool_;
+  Array<Event,EVENT_COUNT_MAX> & event_array_;
+  uint8_t owner_;
   const Functor1<int> functor_dummy_;
   size_t timer_number_;
+  enum{DEFERRED_CALL_COUNT_MAX=((EVENT_CONTROLLER_DEFERRED_COUNT_MAX + EVENT_COUNT_MAX) < 255) ? (EVENT_CONTROLLER_DEFERRED_COUNT_MAX + EVENT_COUNT_MAX) : 255};
+  struct DeferredCall
+  {
+    Functor1<int> functor;
+    int arg;
+    EventId event_id;
+  };
+  DeferredCall deferred_calls_[DEFERRED_CALL_COUNT_MAX];
+  volatile uint8_t deferred_head_;
+  volatile uint8_t deferred_tail_;
+  volatile uint16_t deferred_overflow_count_;
+  EventHandler * handlers_;
+  uint8_t handler_count_;
+  volatile bool measure_costs_;
+  EventSequenceRecord * sequence_records_;
+  uint8_t sequence_record_count_max_;
+  volatile uint8_t sequence_head_;
+  volatile uint8_t sequence_tail_;
+  uint8_t sequence_low_watermark_;
+  volatile uint16_t sequence_underrun_count_;
+  uint16_t sequence_remainder_us_;
+  uint8_t sequence_event_index_;
+  Functor1<int> sequence_functor_;
+  Functor1<int> sequence_functor_low_watermark_;
+  uint32_t poll_time_us_;
+  uint32_t poll_remainder_us_;
+  uint32_t poll_lag_max_us_;
+#if defined(EVENT_CONTROLLER_COROUTINES)
+  EventTaskPromise * task_promises_[EVENT_COUNT_MAX];
+#endif
+  struct LoadEvent
+  {
+    int32_t time;
+    uint32_t period;
+    uint16_t period_remainder;
+    uint16_t period_denominator;
+    uint16_t phase;
+    uint16_t remaining;
+    uint32_t cost_us;
+    uint8_t events;
+    bool active;
+    bool infinite;
+    bool rearm;
+  };
+  LoadEvent load_events_[EVENT_COUNT_MAX];
+  enum ScheduleFlag
+  {
+    SCHEDULE_FLAG_ENABLED,
+    SCHEDULE_FLAG_INFINITE,
+    SCHEDULE_FLAG_ARMED,
+    SCHEDULE_FLAG_REARM,
+    SCHEDULE_FLAG_DEFERRED,
+    SCHEDULE_FLAG_BATCHED,
+  };
 
+  friend EVENT_TIMER;
+  static EventController * instance_;
+  static void isr();
   void startTimer();
-  uint8_t findAvailableEventIndex();
+  uint32_t millisToTicks(uint32_t ms);
+  uint32_t microsToTicks(uint32_t us);
+  uint32_t timeToTicks(uint32_t time);
+  TickPeriod periodFromMillis(const EventPeriod period);
+  TickPeriod periodFromMicros(uint32_t period_us);
+  EventId addEventUsingTicks(const Functor1<int> & functor,
+    uint32_t time,
+    const TickPeriod period,
+    int32_t count,
+    int arg);
+  EventId addEventUsingTicksUnlocked(const Functor1<int> & functor,
+    uint32_t time,
+    const TickPeriod period,
+    int32_t count,
+    int arg);
+  EventIdPair addPwmUsingTicks(const Functor1<int> & functor_0,
+    const Functor1<int> & functor_1,
+    uint32_t time,
+    TickPeriod period,
+    uint32_t on_duration,
+    int32_t count,
+    int arg);
+#if defined(EVENT_CONTROLLER_COROUTINES)
+  friend class EventTaskAwaiter<EventController>;
+  friend class EventTaskPromise;
+  bool allocateTask(EventTaskPromise & promise);
+  bool scheduleTask(EventTaskPromise & promise,
+    uint32_t time);
+  void resumeTask(int event_index);
+  void releaseTask(int event_index);
+  void detachTask(uint8_t event_index);
+#endif
+  void setHandler(Event & event,
+    uint8_t handler);
+  void writeValue(uint8_t * & buffer,
+    uint32_t value,
+    uint8_t byte_count);
+  uint32_t readValue(const uint8_t * & buffer,
+    uint8_t byte_count);
+  void writeScheduleHeader(uint8_t * header,
+    uint8_t record_count);
+  bool readScheduleHeader(const uint8_t * header,
+    uint8_t & record_count);
+  bool eventSavable(const Event & event);
+  bool scheduleSavable();
+  void clearUnrestorable();
+  void clearOwned();
+  uint16_t scheduleCrc(const uint8_t * buffer,
+    size_t buffer_size);
+  void writeScheduleCrc(uint8_t * record);
+  bool scheduleRecordValid(const uint8_t * record);
+  void writeScheduleRecord(uint8_t * record,
+    uint8_t event_index,
+    uint32_t ticks);
+  void readScheduleRecord(const uint8_t * record,
+    uint32_t ticks,
+    uint32_t elapsed);
+  void catchUp(Event & event,
+    uint32_t ticks);
+  void executeCommand(uint8_t op,
+    const uint8_t * command,
+    uint8_t * & result);
+  void initialize();
+  uint8_t sequencePending();
+  bool scheduleSequence(Event & event);
+  void playSequence(int);
+  bool owns(uint8_t event_index);
+  bool eventIdValid(const EventId event_id);
+  void detach(uint8_t event_index,
+    Functor1<int> & functor_stop,
+    int & arg);
+  bool getOffsetTime(const EventId event_id_origin,
+    uint32_t offset,
+    uint32_t & time);
+  EventId addTimeoutUsingTicks(const Functor1<int> & functor,
+    uint32_t timeout,
+    int arg);
+  uint32_t getTicksUnlocked();
+  void arm(const EventId event_id,
+    uint32_t delay);
+  void arm(const EventIdPair event_id_pair,
+    uint32_t delay);
+  void trigger(uint8_t event_index,
+    uint32_t ticks);
+  bool timeReached(uint32_t time);
+  bool coalesce(uint8_t event_index_leader,
+    uint8_t event_index);
+  void unlinkBatch(uint8_t event_index);
+  void removeBatch(uint8_t event_index);
+  bool defer(const Functor1<int> & functor,
+    int arg,
+    uint8_t event_index);
+  void invoke(const Functor1<int> & functor,
+    const Event & event);
+  void dispatch(Event & event);
   void update();
+  bool eventDue(uint8_t event_index);
+  void advanceTicks(uint32_t tick_count);
+  void advancePeriod(Event & event);
+  void process(uint8_t event_index,
+    bool catch_up);
   void remove(uint8_t event_index);
   void clear(uint8_t event_index);
   void enable(uint8_t event_index);
   void disable(uint8_t event_index);
 };
 
-bool operator==(const EventId& lhs,
-  const EventId& rhs);
-bool operator==(const EventIdPair& lhs,
-  const EventIdPair& rhs);
-bool operator!=(const EventId& lhs,
-  const EventId& rhs);
-bool operator!=(const EventIdPair& lhs,
-  const EventIdPair& rhs);
-
+#include "EventController/EventPoolDefinitions.h"
 #include "EventController/EventControllerDefinitions.h"
 
 #endif
@@ -5,7 +5,7 @@
 // Authors:
 // Peter Polidoro peter@polidoro.io
 // ----------------------------------------------------------------------------
-#include "../EventController.h"
+#include "EventId.h"
 
 
 bool operator==(const EventId& lhs,
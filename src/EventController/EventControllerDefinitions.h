@@ -9,15 +9,62 @@
 #define EVENT_CONTROLLER_DEFINITIONS_H
 
 
-template <uint8_t EVENT_COUNT_MAX>
-EventController<EVENT_COUNT_MAX>::EventController()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER> * EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::instance_ = 0;
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::EventController() :
+event_pool_(event_pool_storage_.event_pool),
+event_array_(event_pool_.getEventArray())
+{
+  initialize();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::EventController(EventPool<EVENT_COUNT_MAX> & event_pool) :
+event_pool_(event_pool),
+event_array_(event_pool_.getEventArray())
 {
+  initialize();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::initialize()
+{
+  owner_ = EventPool<EVENT_COUNT_MAX>::OWNER_NONE;
   timer_number_ = 1;
-  millis_ = 0;
+  ticks_ = 0;
+  ticks_epoch_ = 0;
+  slew_remaining_ = 0;
+  slew_period_ = SLEW_PERIOD_DEFAULT;
+  slew_count_ = 0;
+  deferred_head_ = 0;
+  deferred_tail_ = 0;
+  deferred_overflow_count_ = 0;
+  handlers_ = 0;
+  handler_count_ = 0;
+  measure_costs_ = false;
+  sequence_records_ = 0;
+  sequence_record_count_max_ = 0;
+  sequence_head_ = 0;
+  sequence_tail_ = 0;
+  sequence_low_watermark_ = 0;
+  sequence_underrun_count_ = 0;
+  sequence_remainder_us_ = 0;
+  sequence_event_index_ = EVENT_INDEX_NONE;
+  poll_time_us_ = 0;
+  poll_remainder_us_ = 0;
+  poll_lag_max_us_ = 0;
+#if defined(EVENT_CONTROLLER_COROUTINES)
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    task_promises_[event_index] = 0;
+  }
+#endif
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::setup(size_t timer_number)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setup(size_t timer_number)
 {
   if ((timer_number == 1) || (timer_number == 3))
   {
@@ -27,214 +74,315 @@ void EventController<EVENT_COUNT_MAX>::setup(size_t timer_number)
   {
     timer_number_ = 1;
   }
-  event_array_.fill(Event());
+  if (owner_ == EventPool<EVENT_COUNT_MAX>::OWNER_NONE)
+  {
+    owner_ = event_pool_.addOwner();
+  }
   removeAllEvents();
+  poll_time_us_ = micros();
+  poll_remainder_us_ = 0;
+  poll_lag_max_us_ = 0;
   startTimer();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-uint32_t EventController<EVENT_COUNT_MAX>::getTime()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getTime()
 {
-  uint32_t time;
+  uint32_t ticks;
+  uint32_t ticks_epoch;
+  noInterrupts();
+  ticks = ticks_;
+  ticks_epoch = ticks_epoch_;
+  interrupts();
+  if (TICKS_PER_MILLI_SEC == 1)
+  {
+    return ticks;
+  }
+  return ((((uint64_t)ticks_epoch) << 32) | ticks) / TICKS_PER_MILLI_SEC;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getTicks()
+{
+  uint32_t ticks;
+  noInterrupts();
+  ticks = ticks_;
+  interrupts();
+  return ticks;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setTime(uint32_t time)
+{
+  uint64_t ticks = (uint64_t)time * TICKS_PER_MILLI_SEC;
+  noInterrupts();
+  ticks_ = ticks;
+  ticks_epoch_ = ticks >> 32;
+  slew_remaining_ = 0;
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::rebaseTime(uint32_t time)
+{
+  uint64_t ticks = (uint64_t)time * TICKS_PER_MILLI_SEC;
+  noInterrupts();
+  uint32_t time_delta = (uint32_t)ticks - ticks_;
+  ticks_ = ticks;
+  ticks_epoch_ = ticks >> 32;
+  slew_remaining_ = 0;
+  for (uint8_t event_index = 0; event_index < EVENT_COUNT_MAX; ++event_index)
+  {
+    Event & event = event_array_[event_index];
+    if (!event.free && owns(event_index))
+    {
+      event.time += time_delta;
+    }
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::slewTime(uint32_t time,
+  uint16_t slew_period)
+{
+  if (slew_period == 0)
+  {
+    slew_period = 1;
+  }
   noInterrupts();
-  time = millis_;
+  slew_remaining_ = timeToTicks(time) - ticks_;
+  slew_period_ = slew_period;
+  slew_count_ = 0;
   interrupts();
-  return time;
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::setTime(uint32_t time)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+int32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getSlewRemaining()
 {
+  int32_t slew_remaining;
   noInterrupts();
-  millis_ = time;
+  slew_remaining = slew_remaining_;
   interrupts();
+  return slew_remaining;
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addEvent(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEvent(const Functor1<int> & functor,
   int arg)
 {
-  return addEventUsingTime(functor,
+  return addEventUsingTicks(functor,
     0,
+    TickPeriod(),
+    1,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addRecurringEvent(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEvent(const Functor1<int> & functor,
   uint32_t period_ms,
   int32_t count,
   int arg)
+{
+  return addEventUsingTicks(functor,
+    0,
+    periodFromMillis(EventPeriod(period_ms)),
+    count,
+    arg);
+}
 
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEvent(const Functor1<int> & functor,
+  const EventPeriod period,
+  int32_t count,
+  int arg)
 {
-  if (count < 0)
-  {
-    return addInfiniteRecurringEvent(functor,period_ms,arg);
-  }
-  return addRecurringEventUsingTime(functor,
+  return addEventUsingTicks(functor,
     0,
-    period_ms,
+    periodFromMillis(period),
     count,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addInfiniteRecurringEvent(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEvent(const Functor1<int> & functor,
   uint32_t period_ms,
   int arg)
 {
-  return addInfiniteRecurringEventUsingTime(functor,
+  return addEventUsingTicks(functor,
+    0,
+    periodFromMillis(EventPeriod(period_ms)),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEvent(const Functor1<int> & functor,
+  const EventPeriod period,
+  int arg)
+{
+  return addEventUsingTicks(functor,
     0,
-    period_ms,
+    periodFromMillis(period),
+    -1,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addEventUsingTime(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEventUsingTime(const Functor1<int> & functor,
   uint32_t time,
   int arg)
 {
-  uint32_t time_start = getTime();
-  uint8_t event_index = findAvailableEventIndex();
-  if (event_index < EVENT_COUNT_MAX)
-  {
-    Event & event = event_array_[event_index];
-    event.functor = functor;
-    event.time_start = time_start;
-    event.time = time;
-    event.free = false;
-    event.enabled = false;
-    event.infinite = false;
-    event.count = 1;
-    event.period_ms = 0;
-    event.inc = 0;
-    event.arg = arg;
-  }
-  EventId event_id;
-  event_id.index = event_index;
-  event_id.time_start = time_start;
-  return event_id;
+  return addEventUsingTicks(functor,
+    timeToTicks(time),
+    TickPeriod(),
+    1,
+    arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addRecurringEventUsingTime(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingTime(const Functor1<int> & functor,
   uint32_t time,
   uint32_t period_ms,
   int32_t count,
   int arg)
 {
-  if (count < 0)
-  {
-    return addInfiniteRecurringEventUsingTime(functor,time,period_ms,arg);
-  }
-  uint32_t time_start = getTime();
-  uint8_t event_index = findAvailableEventIndex();
-  if (event_index < EVENT_COUNT_MAX)
-  {
-    Event & event = event_array_[event_index];
-    event.functor = functor;
-    event.time_start = time_start;
-    event.time = time;
-    event.free = false;
-    event.enabled = false;
-    event.infinite = false;
-    event.period_ms = period_ms;
-    event.count = count;
-    event.inc = 0;
-    event.arg = arg;
-  }
-  EventId event_id;
-  event_id.index = event_index;
-  event_id.time_start = time_start;
-  return event_id;
+  return addEventUsingTicks(functor,
+    timeToTicks(time),
+    periodFromMillis(EventPeriod(period_ms)),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingTime(const Functor1<int> & functor,
+  uint32_t time,
+  const EventPeriod period,
+  int32_t count,
+  int arg)
+{
+  return addEventUsingTicks(functor,
+    timeToTicks(time),
+    periodFromMillis(period),
+    count,
+    arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addInfiniteRecurringEventUsingTime(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingTime(const Functor1<int> & functor,
   uint32_t time,
   uint32_t period_ms,
   int arg)
 {
-  uint32_t time_start = getTime();
-  uint8_t event_index = findAvailableEventIndex();
-  if (event_index < EVENT_COUNT_MAX)
-  {
-    Event & event = event_array_[event_index];
-    event.functor = functor;
-    event.time_start = time_start;
-    event.time = time;
-    event.free = false;
-    event.enabled = false;
-    event.infinite = true;
-    event.period_ms = period_ms;
-    event.count = 0;
-    event.inc = 0;
-    event.arg = arg;
-  }
-  EventId event_id;
-  event_id.index = event_index;
-  event_id.time_start = time_start;
-  return event_id;
+  return addEventUsingTicks(functor,
+    timeToTicks(time),
+    periodFromMillis(EventPeriod(period_ms)),
+    -1,
+    arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addEventUsingDelay(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingTime(const Functor1<int> & functor,
+  uint32_t time,
+  const EventPeriod period,
+  int arg)
+{
+  return addEventUsingTicks(functor,
+    timeToTicks(time),
+    periodFromMillis(period),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEventUsingDelay(const Functor1<int> & functor,
   uint32_t delay,
   int arg)
 {
-  uint32_t time_now = getTime();
-  uint32_t time = time_now + delay;
-  return addEventUsingTime(functor,
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addEventUsingTicks(functor,
     time,
+    TickPeriod(),
+    1,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addRecurringEventUsingDelay(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingDelay(const Functor1<int> & functor,
   uint32_t delay,
   uint32_t period_ms,
   int32_t count,
   int arg)
 {
-  if (count < 0)
-  {
-    return addInfiniteRecurringEventUsingDelay(functor,delay,period_ms,arg);
-  }
-  uint32_t time_now = getTime();
-  uint32_t time = time_now + delay;
-  return addRecurringEventUsingTime(functor,
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addEventUsingTicks(functor,
     time,
-    period_ms,
+    periodFromMillis(EventPeriod(period_ms)),
     count,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addInfiniteRecurringEventUsingDelay(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingDelay(const Functor1<int> & functor,
+  uint32_t delay,
+  const EventPeriod period,
+  int32_t count,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addEventUsingTicks(functor,
+    time,
+    periodFromMillis(period),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingDelay(const Functor1<int> & functor,
   uint32_t delay,
   uint32_t period_ms,
   int arg)
 {
-  uint32_t time_now = getTime();
-  uint32_t time = time_now + delay;
-  return addInfiniteRecurringEventUsingTime(functor,
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addEventUsingTicks(functor,
+    time,
+    periodFromMillis(EventPeriod(period_ms)),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingDelay(const Functor1<int> & functor,
+  uint32_t delay,
+  const EventPeriod period,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addEventUsingTicks(functor,
     time,
-    period_ms,
+    periodFromMillis(period),
+    -1,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addEventUsingOffset(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEventUsingOffset(const Functor1<int> & functor,
   const EventId event_id_origin,
   uint32_t offset,
   int arg)
 {
-  uint8_t event_index_origin = event_id_origin.index;
-  if (event_index_origin < EVENT_COUNT_MAX)
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    uint32_t time_origin = event_array_[event_index_origin].time;
-    uint32_t time = time_origin + offset;
-    return addEventUsingTime(functor,
+    return addEventUsingTicks(functor,
       time,
+      TickPeriod(),
+      1,
       arg);
   }
   else
@@ -243,26 +391,20 @@ EventId EventController<EVENT_COUNT_MAX>::addEventUsingOffset(const Functor1<int
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addRecurringEventUsingOffset(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingOffset(const Functor1<int> & functor,
   const EventId event_id_origin,
   uint32_t offset,
   uint32_t period_ms,
   int32_t count,
   int arg)
 {
-  if (count < 0)
-  {
-    return addInfiniteRecurringEventUsingOffset(functor,event_id_origin,offset,period_ms,arg);
-  }
-  uint8_t event_index_origin = event_id_origin.index;
-  if (event_index_origin < EVENT_COUNT_MAX)
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    uint32_t time_origin = event_array_[event_index_origin].time;
-    uint32_t time = time_origin + offset;
-    return addRecurringEventUsingTime(functor,
+    return addEventUsingTicks(functor,
       time,
-      period_ms,
+      periodFromMillis(EventPeriod(period_ms)),
       count,
       arg);
   }
@@ -272,21 +414,21 @@ EventId EventController<EVENT_COUNT_MAX>::addRecurringEventUsingOffset(const Fun
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventId EventController<EVENT_COUNT_MAX>::addInfiniteRecurringEventUsingOffset(const Functor1<int> & functor,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingOffset(const Functor1<int> & functor,
   const EventId event_id_origin,
   uint32_t offset,
-  uint32_t period_ms,
+  const EventPeriod period,
+  int32_t count,
   int arg)
 {
-  uint8_t event_index_origin = event_id_origin.index;
-  if (event_index_origin < EVENT_COUNT_MAX)
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    uint32_t time_origin = event_array_[event_index_origin].time;
-    uint32_t time = time_origin + offset;
-    return addInfiniteRecurringEventUsingTime(functor,
+    return addEventUsingTicks(functor,
       time,
-      period_ms,
+      periodFromMillis(period),
+      count,
       arg);
   }
   else
@@ -295,63 +437,88 @@ EventId EventController<EVENT_COUNT_MAX>::addInfiniteRecurringEventUsingOffset(c
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventIdPair EventController<EVENT_COUNT_MAX>::addPwmUsingTime(const Functor1<int> & functor_0,
-  const Functor1<int> & functor_1,
-  uint32_t time,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingOffset(const Functor1<int> & functor,
+  const EventId event_id_origin,
+  uint32_t offset,
   uint32_t period_ms,
-  uint32_t on_duration_ms,
-  int32_t count,
   int arg)
 {
-  if (count < 0)
-  {
-    return addInfinitePwmUsingTime(functor_0,functor_1,time,period_ms,on_duration_ms,arg);
-  }
-  EventIdPair event_id_pair;
-  if ((period_ms == 0) && (on_duration_ms == 0))
-  {
-    return event_id_pair;
-  }
-  if (period_ms < on_duration_ms)
-  {
-    period_ms = on_duration_ms;
-  }
-  if ((on_duration_ms > 0) && (on_duration_ms < period_ms))
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    event_id_pair.event_id_0 = addRecurringEventUsingTime(functor_0,
+    return addEventUsingTicks(functor,
       time,
-      period_ms,
-      count,
-      arg);
-    event_id_pair.event_id_1 = addRecurringEventUsingOffset(functor_1,
-      event_id_pair.event_id_0,
-      on_duration_ms,
-      period_ms,
-      count,
+      periodFromMillis(EventPeriod(period_ms)),
+      -1,
       arg);
   }
-  else if (on_duration_ms == 0)
+  else
+  {
+    return EventId();
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingOffset(const Functor1<int> & functor,
+  const EventId event_id_origin,
+  uint32_t offset,
+  const EventPeriod period,
+  int arg)
+{
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    event_id_pair.event_id_0 = addRecurringEventUsingTime(functor_1,
+    return addEventUsingTicks(functor,
       time,
-      period_ms,
-      count,
+      periodFromMillis(period),
+      -1,
       arg);
   }
   else
   {
-    event_id_pair.event_id_0 = addRecurringEventUsingTime(functor_0,
-      time,
-      period_ms,
-      count,
-      arg);
+    return EventId();
   }
-  return event_id_pair;
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventIdPair EventController<EVENT_COUNT_MAX>::addPwmUsingDelay(const Functor1<int> & functor_0,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingTime(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t time,
+  uint32_t period_ms,
+  uint32_t on_duration_ms,
+  int32_t count,
+  int arg)
+{
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    timeToTicks(time),
+    periodFromMillis(EventPeriod(period_ms)),
+    millisToTicks(on_duration_ms),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingTime(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t time,
+  const EventPeriod period,
+  uint32_t on_duration_ms,
+  int32_t count,
+  int arg)
+{
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    timeToTicks(time),
+    periodFromMillis(period),
+    millisToTicks(on_duration_ms),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingDelay(const Functor1<int> & functor_0,
   const Functor1<int> & functor_1,
   uint32_t delay,
   uint32_t period_ms,
@@ -359,23 +526,39 @@ EventIdPair EventController<EVENT_COUNT_MAX>::addPwmUsingDelay(const Functor1<in
   int32_t count,
   int arg)
 {
-  if (count < 0)
-  {
-    return addInfinitePwmUsingDelay(functor_0,functor_1,delay,period_ms,on_duration_ms,arg);
-  }
-  uint32_t time_now = getTime();
-  uint32_t time = time_now + delay;
-  return addPwmUsingTime(functor_0,
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    time,
+    periodFromMillis(EventPeriod(period_ms)),
+    millisToTicks(on_duration_ms),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingDelay(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t delay,
+  const EventPeriod period,
+  uint32_t on_duration_ms,
+  int32_t count,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addPwmUsingTicks(functor_0,
     functor_1,
     time,
-    period_ms,
-    on_duration_ms,
+    periodFromMillis(period),
+    millisToTicks(on_duration_ms),
     count,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventIdPair EventController<EVENT_COUNT_MAX>::addPwmUsingOffset(const Functor1<int> & functor_0,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingOffset(const Functor1<int> & functor_0,
   const Functor1<int> & functor_1,
   const EventId event_id_origin,
   uint32_t offset,
@@ -384,20 +567,14 @@ EventIdPair EventController<EVENT_COUNT_MAX>::addPwmUsingOffset(const Functor1<i
   int32_t count,
   int arg)
 {
-  if (count < 0)
-  {
-    return addInfinitePwmUsingOffset(functor_0,functor_1,event_id_origin,offset,period_ms,on_duration_ms,arg);
-  }
-  uint8_t event_index_origin = event_id_origin.index;
-  if (event_index_origin < EVENT_COUNT_MAX)
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    uint32_t time_origin = event_array_[event_index_origin].time;
-    uint32_t time = time_origin + offset;
-    return addPwmUsingTime(functor_0,
+    return addPwmUsingTicks(functor_0,
       functor_1,
       time,
-      period_ms,
-      on_duration_ms,
+      periodFromMillis(EventPeriod(period_ms)),
+      millisToTicks(on_duration_ms),
       count,
       arg);
   }
@@ -407,82 +584,124 @@ EventIdPair EventController<EVENT_COUNT_MAX>::addPwmUsingOffset(const Functor1<i
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventIdPair EventController<EVENT_COUNT_MAX>::addInfinitePwmUsingTime(const Functor1<int> & functor_0,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingOffset(const Functor1<int> & functor_0,
   const Functor1<int> & functor_1,
-  uint32_t time,
-  uint32_t period_ms,
+  const EventId event_id_origin,
+  uint32_t offset,
+  const EventPeriod period,
   uint32_t on_duration_ms,
+  int32_t count,
   int arg)
 {
-  EventIdPair event_id_pair;
-  if ((on_duration_ms > 0) && (on_duration_ms < period_ms))
-  {
-    event_id_pair.event_id_0 = addInfiniteRecurringEventUsingTime(functor_0,
-      time,
-      period_ms,
-      arg);
-    event_id_pair.event_id_1 = addInfiniteRecurringEventUsingOffset(functor_1,
-      event_id_pair.event_id_0,
-      on_duration_ms,
-      period_ms,
-      arg);
-  }
-  else if (on_duration_ms == 0)
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
   {
-    event_id_pair.event_id_0 = addInfiniteRecurringEventUsingTime(functor_1,
+    return addPwmUsingTicks(functor_0,
+      functor_1,
       time,
-      period_ms,
+      periodFromMillis(period),
+      millisToTicks(on_duration_ms),
+      count,
       arg);
   }
   else
   {
-    event_id_pair.event_id_0 = addInfiniteRecurringEventUsingTime(functor_0,
-      time,
-      period_ms,
-      arg);
+    return EventIdPair();
   }
-  return event_id_pair;
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventIdPair EventController<EVENT_COUNT_MAX>::addInfinitePwmUsingDelay(const Functor1<int> & functor_0,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingTime(const Functor1<int> & functor_0,
   const Functor1<int> & functor_1,
-  uint32_t delay,
+  uint32_t time,
   uint32_t period_ms,
   uint32_t on_duration_ms,
   int arg)
 {
-  uint32_t time_now = getTime();
-  uint32_t time = time_now + delay;
-  return addInfinitePwmUsingTime(functor_0,
+  return addPwmUsingTicks(functor_0,
     functor_1,
-    time,
-    period_ms,
-    on_duration_ms,
+    timeToTicks(time),
+    periodFromMillis(EventPeriod(period_ms)),
+    millisToTicks(on_duration_ms),
+    -1,
     arg);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-EventIdPair EventController<EVENT_COUNT_MAX>::addInfinitePwmUsingOffset(const Functor1<int> & functor_0,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingTime(const Functor1<int> & functor_0,
   const Functor1<int> & functor_1,
-  const EventId event_id_origin,
-  uint32_t offset,
-  uint32_t period_ms,
+  uint32_t time,
+  const EventPeriod period,
   uint32_t on_duration_ms,
   int arg)
 {
-  uint8_t event_index_origin = event_id_origin.index;
-  if (event_index_origin < EVENT_COUNT_MAX)
-  {
-    uint32_t time_origin = event_array_[event_index_origin].time;
-    uint32_t time = time_origin + offset;
-    return addInfinitePwmUsingTime(functor_0,
-      functor_1,
-      time,
-      period_ms,
-      on_duration_ms,
-      arg);
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    timeToTicks(time),
+    periodFromMillis(period),
+    millisToTicks(on_duration_ms),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingDelay(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t delay,
+  uint32_t period_ms,
+  uint32_t on_duration_ms,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    time,
+    periodFromMillis(EventPeriod(period_ms)),
+    millisToTicks(on_duration_ms),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingDelay(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t delay,
+  const EventPeriod period,
+  uint32_t on_duration_ms,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + millisToTicks(delay);
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    time,
+    periodFromMillis(period),
+    millisToTicks(on_duration_ms),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingOffset(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  const EventId event_id_origin,
+  uint32_t offset,
+  uint32_t period_ms,
+  uint32_t on_duration_ms,
+  int arg)
+{
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
+  {
+    return addPwmUsingTicks(functor_0,
+      functor_1,
+      time,
+      periodFromMillis(EventPeriod(period_ms)),
+      millisToTicks(on_duration_ms),
+      -1,
+      arg);
   }
   else
   {
@@ -490,386 +709,2596 @@ EventIdPair EventController<EVENT_COUNT_MAX>::addInfinitePwmUsingOffset(const Fu
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::addStartFunctor(const EventId event_id,
-  const Functor1<int> & functor)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingOffset(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  const EventId event_id_origin,
+  uint32_t offset,
+  const EventPeriod period,
+  uint32_t on_duration_ms,
+  int arg)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  uint32_t time;
+  if (getOffsetTime(event_id_origin,millisToTicks(offset),time))
+  {
+    return addPwmUsingTicks(functor_0,
+      functor_1,
+      time,
+      periodFromMillis(period),
+      millisToTicks(on_duration_ms),
+      -1,
+      arg);
+  }
+  else
   {
-    event_array_[event_index].functor_start = functor;
+    return EventIdPair();
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::addStopFunctor(const EventId event_id,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEventUsingDelayMicros(const Functor1<int> & functor,
+  uint32_t delay_us,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + microsToTicks(delay_us);
+  return addEventUsingTicks(functor,
+    time,
+    TickPeriod(),
+    1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addRecurringEventUsingDelayMicros(const Functor1<int> & functor,
+  uint32_t delay_us,
+  uint32_t period_us,
+  int32_t count,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + microsToTicks(delay_us);
+  return addEventUsingTicks(functor,
+    time,
+    periodFromMicros(period_us),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfiniteRecurringEventUsingDelayMicros(const Functor1<int> & functor,
+  uint32_t delay_us,
+  uint32_t period_us,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + microsToTicks(delay_us);
+  return addEventUsingTicks(functor,
+    time,
+    periodFromMicros(period_us),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingDelayMicros(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t delay_us,
+  uint32_t period_us,
+  uint32_t on_duration_us,
+  int32_t count,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + microsToTicks(delay_us);
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    time,
+    periodFromMicros(period_us),
+    microsToTicks(on_duration_us),
+    count,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addInfinitePwmUsingDelayMicros(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t delay_us,
+  uint32_t period_us,
+  uint32_t on_duration_us,
+  int arg)
+{
+  uint32_t time_now = getTicks();
+  uint32_t time = time_now + microsToTicks(delay_us);
+  return addPwmUsingTicks(functor_0,
+    functor_1,
+    time,
+    periodFromMicros(period_us),
+    microsToTicks(on_duration_us),
+    -1,
+    arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addStartFunctor(const EventId event_id,
   const Functor1<int> & functor)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].functor_stop = functor;
+    event_array_[event_id.index].functor_start = functor;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::replaceFunctor(const EventId event_id,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addStopFunctor(const EventId event_id,
   const Functor1<int> & functor)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].functor = functor;
+    event_array_[event_id.index].functor_stop = functor;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::addStartFunctor(const EventIdPair event_id_pair,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::replaceFunctor(const EventId event_id,
   const Functor1<int> & functor)
 {
-  const EventId & event_id = event_id_pair.event_id_0;
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].functor_start = functor;
+    event_array_[event_id.index].functor = functor;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::addStopFunctor(const EventIdPair event_id_pair,
-  const Functor1<int> & functor)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setPinAction(const EventId event_id,
+  size_t pin,
+  EventAction action)
 {
-  const EventId & event_id = event_id_pair.event_id_0;
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  volatile EventPortRegister * port_register = (volatile EventPortRegister *)portOutputRegister(digitalPinToPort(pin));
+  noInterrupts();
+  if (eventIdValid(event_id))
+  {
+    Event & event = event_array_[event_id.index];
+    event.port_register = port_register;
+    event.port_bit_mask = digitalPinToBitMask(pin);
+    event.pin = PIN_NONE;
+    if (port_register && (pin < PIN_NONE))
+    {
+      event.pin = pin;
+    }
+    event.action = (port_register ? action : EVENT_ACTION_FUNCTOR);
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setPinActions(const EventIdPair event_id_pair,
+  size_t pin,
+  EventAction action_0,
+  EventAction action_1)
+{
+  setPinAction(event_id_pair.event_id_0,pin,action_0);
+  setPinAction(event_id_pair.event_id_1,pin,action_1);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setRegisterAction(const EventId event_id,
+  volatile EventPortRegister * port_register,
+  EventPortRegister port_bit_mask,
+  EventAction action)
+{
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].functor_stop = functor;
+    Event & event = event_array_[event_id.index];
+    event.port_register = port_register;
+    event.port_bit_mask = port_bit_mask;
+    event.pin = PIN_NONE;
+    event.action = (port_register ? action : EVENT_ACTION_FUNCTOR);
   }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addStartFunctor(const EventIdPair event_id_pair,
+  const Functor1<int> & functor)
+{
+  addStartFunctor(event_id_pair.event_id_0,functor);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addStopFunctor(const EventIdPair event_id_pair,
+  const Functor1<int> & functor)
+{
+  addStopFunctor(event_id_pair.event_id_0,functor);
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::replaceFunctors(const EventIdPair event_id_pair,
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::replaceFunctors(const EventIdPair event_id_pair,
   const Functor1<int> & functor_0,
   const Functor1<int> & functor_1)
 {
-  const EventId & event_id_0 = event_id_pair.event_id_0;
-  uint8_t event_index_0 = event_id_0.index;
-  if ((event_index_0 < EVENT_COUNT_MAX) &&
-    (event_array_[event_index_0].time_start == event_id_0.time_start) &&
-    !event_array_[event_index_0].free)
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
   {
-    event_array_[event_index_0].functor = functor_0;
+    event_array_[event_id_pair.event_id_0.index].functor = functor_0;
   }
-
-  const EventId & event_id_1 = event_id_pair.event_id_1;
-  uint8_t event_index_1 = event_id_1.index;
-  if ((event_index_1 < EVENT_COUNT_MAX) &&
-    (event_array_[event_index_1].time_start == event_id_1.time_start) &&
-    !event_array_[event_index_1].free)
+  if (eventIdValid(event_id_pair.event_id_1))
   {
-    event_array_[event_index_1].functor = functor_1;
+    event_array_[event_id_pair.event_id_1.index].functor = functor_1;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::remove(const EventId event_id)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::remove(const EventId event_id)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) && (event_array_[event_index].time_start == event_id.time_start))
+  Functor1<int> functor_stop;
+  int arg = -1;
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    remove(event_index);
+    detach(event_id.index,functor_stop,arg);
+  }
+  interrupts();
+  if (functor_stop)
+  {
+    functor_stop(arg);
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::remove(const EventIdPair event_id_pair)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::remove(const EventIdPair event_id_pair)
 {
-  remove(event_id_pair.event_id_0);
-  remove(event_id_pair.event_id_1);
+  Functor1<int> functor_stop_0;
+  Functor1<int> functor_stop_1;
+  int arg_0 = -1;
+  int arg_1 = -1;
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    detach(event_id_pair.event_id_0.index,functor_stop_0,arg_0);
+  }
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    detach(event_id_pair.event_id_1.index,functor_stop_1,arg_1);
+  }
+  interrupts();
+  if (functor_stop_0)
+  {
+    functor_stop_0(arg_0);
+  }
+  if (functor_stop_1)
+  {
+    functor_stop_1(arg_1);
+  }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::remove(uint8_t event_index)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::remove(uint8_t event_index)
 {
   if (event_index < EVENT_COUNT_MAX)
   {
-    Event & event = event_array_[event_index];
-    if (event.functor_stop)
+    Functor1<int> functor_stop;
+    int arg = -1;
+    noInterrupts();
+    detach(event_index,functor_stop,arg);
+    interrupts();
+    if (functor_stop)
     {
-      event.functor_stop(event.arg);
+      functor_stop(arg);
     }
-    clear(event_index);
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::removeAllEvents()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::removeAllEvents()
 {
-  for (size_t i=0; i<EVENT_COUNT_MAX; ++i)
+  Functor1<int> functors_stop[EVENT_COUNT_MAX];
+  int args[EVENT_COUNT_MAX];
+  noInterrupts();
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    args[event_index] = -1;
+    detach(event_index,functors_stop[event_index],args[event_index]);
+  }
+  ticks_ = 0;
+  ticks_epoch_ = 0;
+  slew_remaining_ = 0;
+  interrupts();
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
   {
-    remove(i);
+    if (functors_stop[event_index])
+    {
+      functors_stop[event_index](args[event_index]);
+    }
   }
-  millis_ = 0;
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::clear(const EventId event_id)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::clear(const EventId event_id)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) && (event_array_[event_index].time_start == event_id.time_start))
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    clear(event_index);
+    clear(event_id.index);
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::clear(const EventIdPair event_id_pair)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::clear(const EventIdPair event_id_pair)
 {
-  clear(event_id_pair.event_id_0);
-  clear(event_id_pair.event_id_1);
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    clear(event_id_pair.event_id_0.index);
+  }
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    clear(event_id_pair.event_id_1.index);
+  }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::clear(uint8_t event_index)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::clear(uint8_t event_index)
 {
-  if (event_index < EVENT_COUNT_MAX)
+  if ((event_index < EVENT_COUNT_MAX) && owns(event_index))
   {
     Event & event = event_array_[event_index];
+    bool allocated = !event.free;
+#if defined(EVENT_CONTROLLER_COROUTINES)
+    if (task_promises_[event_index])
+    {
+      detachTask(event_index);
+      if (event.functor_stop && !defer(event.functor_stop,event.arg,event_index))
+      {
+        deferred_overflow_count_ = deferred_overflow_count_ + 1;
+      }
+    }
+#endif
+    unlinkBatch(event_index);
     event.functor = functor_dummy_;
     event.time_start = 0;
     event.time = 0;
     event.free = true;
     event.enabled = false;
     event.infinite = false;
-    event.period_ms = 0;
+    event.period = 0;
+    event.period_remainder = 0;
+    event.period_denominator = 1;
+    event.phase = 0;
     event.count = 0;
     event.inc = 0;
     event.arg = -1;
+    event.groups = 0;
+    event.action = EVENT_ACTION_FUNCTOR;
+    event.port_register = 0;
+    event.port_bit_mask = 0;
+    event.pin = PIN_NONE;
+    event.batched = false;
+    event.batch_next = EVENT_INDEX_NONE;
+    event.armed = false;
+    event.rearm = false;
+    event.trigger_delay = 0;
+    event.deferred = false;
+    event.handler = HANDLER_NONE;
     event.functor_start = functor_dummy_;
     event.functor_stop = functor_dummy_;
+    if (allocated)
+    {
+      event_pool_.deallocate(event_index);
+    }
+    if (event_index == sequence_event_index_)
+    {
+      sequence_event_index_ = EVENT_INDEX_NONE;
+    }
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::clearAllEvents()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::clearAllEvents()
 {
-  for (size_t i=0; i<EVENT_COUNT_MAX; ++i)
+  noInterrupts();
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
   {
-    clear(i);
+    clear(event_index);
   }
-  millis_ = 0;
+  ticks_ = 0;
+  ticks_epoch_ = 0;
+  slew_remaining_ = 0;
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::enable(const EventId event_id)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::enable(const EventId event_id)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].enabled = true;
+    event_array_[event_id.index].enabled = true;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::enable(const EventIdPair event_id_pair)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::enable(const EventIdPair event_id_pair)
 {
-  enable(event_id_pair.event_id_0);
-  enable(event_id_pair.event_id_1);
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    event_array_[event_id_pair.event_id_0.index].enabled = true;
+  }
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    event_array_[event_id_pair.event_id_1.index].enabled = true;
+  }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::enable(uint8_t event_index)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::enable(uint8_t event_index)
 {
-  if ((event_index < EVENT_COUNT_MAX) && !event_array_[event_index].free)
+  if ((event_index < EVENT_COUNT_MAX) && !event_array_[event_index].free && owns(event_index))
   {
     event_array_[event_index].enabled = true;
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::disable(const EventId event_id)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::disable(const EventId event_id)
 {
-  uint8_t event_index = event_id.index;
-  if ((event_index < EVENT_COUNT_MAX) &&
-    (event_array_[event_index].time_start == event_id.time_start) &&
-    !event_array_[event_index].free)
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].enabled = false;
+    event_array_[event_id.index].enabled = false;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::disable(const EventIdPair event_id_pair)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::disable(const EventIdPair event_id_pair)
 {
-  disable(event_id_pair.event_id_0);
-  disable(event_id_pair.event_id_1);
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    event_array_[event_id_pair.event_id_0.index].enabled = false;
+  }
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    event_array_[event_id_pair.event_id_1.index].enabled = false;
+  }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::disable(uint8_t event_index)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::disable(uint8_t event_index)
 {
-  if ((event_index < EVENT_COUNT_MAX) && !event_array_[event_index].free)
+  if ((event_index < EVENT_COUNT_MAX) && !event_array_[event_index].free && owns(event_index))
   {
     event_array_[event_index].enabled = false;
   }
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-Event EventController<EVENT_COUNT_MAX>::getEvent(const EventId event_id)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addToGroup(const EventId event_id,
+  uint8_t group_mask)
 {
-  uint8_t event_index = event_id.index;
-  if (event_index < EVENT_COUNT_MAX)
-  {
-    return event_array_[event_index];
-  }
-  else
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    return Event();
+    event_array_[event_id.index].groups |= group_mask;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-Event EventController<EVENT_COUNT_MAX>::getEvent(uint8_t event_index)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addToGroup(const EventIdPair event_id_pair,
+  uint8_t group_mask)
 {
-  if (event_index < EVENT_COUNT_MAX)
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
   {
-    return event_array_[event_index];
+    event_array_[event_id_pair.event_id_0.index].groups |= group_mask;
   }
-  else
+  if (eventIdValid(event_id_pair.event_id_1))
   {
-    return Event();
+    event_array_[event_id_pair.event_id_1.index].groups |= group_mask;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::setEventArgToEventIndex(const EventId event_id)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::removeFromGroup(const EventId event_id,
+  uint8_t group_mask)
 {
-  uint8_t event_index = event_id.index;
-  if (event_index < EVENT_COUNT_MAX)
+  noInterrupts();
+  if (eventIdValid(event_id))
   {
-    event_array_[event_index].arg = event_index;
+    event_array_[event_id.index].groups &= ~group_mask;
   }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-uint8_t EventController<EVENT_COUNT_MAX>::eventsActive()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::removeFromGroup(const EventIdPair event_id_pair,
+  uint8_t group_mask)
 {
-  uint8_t events_active = 0;
-  for (uint8_t event_index=0; event_index<event_array_.size(); ++event_index)
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
   {
-    if ((!event_array_[event_index].free) && event_array_[event_index].enabled)
-    {
-      ++events_active;
-    }
+    event_array_[event_id_pair.event_id_0.index].groups &= ~group_mask;
   }
-  return events_active;
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    event_array_[event_id_pair.event_id_1.index].groups &= ~group_mask;
+  }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-uint8_t EventController<EVENT_COUNT_MAX>::eventsAvailable()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::enableGroup(uint8_t group_mask)
 {
-  uint8_t events_available = 0;
-  for (uint8_t event_index=0; event_index<event_array_.size(); ++event_index)
+  noInterrupts();
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
   {
-    if (event_array_[event_index].free)
+    if (event_array_[event_index].groups & group_mask)
     {
-      ++events_available;
+      enable(event_index);
     }
   }
-  return events_available;
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-Array<Event,EVENT_COUNT_MAX> EventController<EVENT_COUNT_MAX>::getEventArray()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::disableGroup(uint8_t group_mask)
 {
-  return event_array_;
+  noInterrupts();
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    if (event_array_[event_index].groups & group_mask)
+    {
+      disable(event_index);
+    }
+  }
+  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::startTimer()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::removeGroup(uint8_t group_mask)
 {
+  Functor1<int> functors_stop[EVENT_COUNT_MAX];
+  int args[EVENT_COUNT_MAX];
   noInterrupts();
-  if (timer_number_ == 1)
-  {
-    Timer1.initialize(MICRO_SEC_PER_MILLI_SEC);
-  }
-  else if (timer_number_ == 3)
-  {
-    Timer3.initialize(MICRO_SEC_PER_MILLI_SEC);
-  }
-  FunctorCallbacks::Callback callback = FunctorCallbacks::add(makeFunctor((Functor0 *)0,*this,&EventController<EVENT_COUNT_MAX>::update));
-  if (callback)
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
   {
-    if (timer_number_ == 1)
+    args[event_index] = -1;
+    if (event_array_[event_index].groups & group_mask)
     {
-      Timer1.attachInterrupt(callback);
+      detach(event_index,functors_stop[event_index],args[event_index]);
     }
-    else if (timer_number_ == 3)
+  }
+  interrupts();
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    if (functors_stop[event_index])
     {
-      Timer3.attachInterrupt(callback);
+      functors_stop[event_index](args[event_index]);
     }
   }
-  interrupts();
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-uint8_t EventController<EVENT_COUNT_MAX>::findAvailableEventIndex()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::armUsingDelay(const EventId event_id,
+  uint32_t delay)
 {
-  uint8_t event_index = 0;
-  while ((event_index < EVENT_COUNT_MAX) && !event_array_[event_index].free)
-  {
-    ++event_index;
-  }
-  return event_index;
+  arm(event_id,millisToTicks(delay));
 }
 
-template <uint8_t EVENT_COUNT_MAX>
-void EventController<EVENT_COUNT_MAX>::update()
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::armUsingDelay(const EventIdPair event_id_pair,
+  uint32_t delay)
 {
-  noInterrupts();
-  ++millis_;
-  interrupts();
+  arm(event_id_pair,millisToTicks(delay));
+}
 
-  for (uint8_t event_index = 0; event_index < EVENT_COUNT_MAX; ++event_index)
-  {
-    Event& event = event_array_[event_index];
-    if ((!event.free) && (event.time <= millis_))
-    {
-      if ((event.enabled) && ((event.infinite) || (event.inc < event.count)))
-      {
-        while ((event.period_ms > 0) &&
-          (event.time <= millis_))
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::armUsingDelayMicros(const EventId event_id,
+  uint32_t delay_us)
+{
+  arm(event_id,microsToTicks(delay_us));
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::armUsingDelayMicros(const EventIdPair event_id_pair,
+  uint32_t delay_us)
+{
+  arm(event_id_pair,microsToTicks(delay_us));
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::trigger(const EventId event_id)
+{
+  noInterrupts();
+  if (eventIdValid(event_id))
+  {
+    trigger(event_id.index,ticks_);
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::trigger(const EventIdPair event_id_pair)
+{
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    trigger(event_id_pair.event_id_0.index,ticks_);
+  }
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    trigger(event_id_pair.event_id_1.index,ticks_);
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addTimeout(const Functor1<int> & functor,
+  uint32_t timeout,
+  int arg)
+{
+  return addTimeoutUsingTicks(functor,millisToTicks(timeout),arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addTimeoutMicros(const Functor1<int> & functor,
+  uint32_t timeout_us,
+  int arg)
+{
+  return addTimeoutUsingTicks(functor,microsToTicks(timeout_us),arg);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::kick(const EventId event_id)
+{
+  noInterrupts();
+  if (eventIdValid(event_id))
+  {
+    Event & event = event_array_[event_id.index];
+    if (event.rearm && (event.trigger_delay > 0))
+    {
+      event.time = ticks_ + event.trigger_delay;
+      event.armed = false;
+    }
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::coalesce(const EventId event_id_leader,
+  const EventId event_id)
+{
+  bool coalesced = false;
+  noInterrupts();
+  if (eventIdValid(event_id_leader) &&
+    eventIdValid(event_id) &&
+    (event_id_leader.index != event_id.index))
+  {
+    coalesced = coalesce(event_id_leader.index,event_id.index);
+  }
+  interrupts();
+  return coalesced;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::coalesceAll()
+{
+  uint8_t coalesced_count = 0;
+  noInterrupts();
+  for (uint8_t event_index_leader=0; event_index_leader<EVENT_COUNT_MAX; ++event_index_leader)
+  {
+    if (event_array_[event_index_leader].free ||
+      event_array_[event_index_leader].batched ||
+      !owns(event_index_leader))
+    {
+      continue;
+    }
+    for (uint8_t event_index=event_index_leader+1; event_index<EVENT_COUNT_MAX; ++event_index)
+    {
+      if (!event_array_[event_index].free && owns(event_index) && coalesce(event_index_leader,event_index))
+      {
+        ++coalesced_count;
+      }
+    }
+  }
+  interrupts();
+  return coalesced_count;
+}
+
+#if defined(EVENT_CONTROLLER_COROUTINES)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventTaskAwaiter<EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER> > EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::delay(uint32_t delay)
+{
+  return EventTaskAwaiter<EventController>(*this,getTicksUnlocked() + millisToTicks(delay));
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventTaskAwaiter<EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER> > EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::delayMicros(uint32_t delay_us)
+{
+  return EventTaskAwaiter<EventController>(*this,getTicksUnlocked() + microsToTicks(delay_us));
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventTaskAwaiter<EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER> > EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::until(uint32_t time)
+{
+  return EventTaskAwaiter<EventController>(*this,timeToTicks(time));
+}
+
+#endif
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setDeferred(const EventId event_id,
+  bool deferred)
+{
+  noInterrupts();
+  if (eventIdValid(event_id))
+  {
+    event_array_[event_id.index].deferred = deferred;
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setDeferred(const EventIdPair event_id_pair,
+  bool deferred)
+{
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    event_array_[event_id_pair.event_id_0.index].deferred = deferred;
+  }
+  if (eventIdValid(event_id_pair.event_id_1))
+  {
+    event_array_[event_id_pair.event_id_1.index].deferred = deferred;
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::dispatchDeferred()
+{
+  uint8_t dispatched_count = 0;
+  uint8_t tail = deferred_tail_;
+  while (tail != __atomic_load_n(&deferred_head_,__ATOMIC_ACQUIRE))
+  {
+    DeferredCall deferred_call = deferred_calls_[tail];
+    tail = (tail + 1) % DEFERRED_CALL_COUNT_MAX;
+    __atomic_store_n(&deferred_tail_,tail,__ATOMIC_RELEASE);
+    deferred_call.functor(deferred_call.arg);
+    ++dispatched_count;
+  }
+  return dispatched_count;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+template <typename Dispatcher>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::dispatchDeferred(Dispatcher & dispatcher)
+{
+  uint8_t dispatched_count = 0;
+  uint8_t tail = deferred_tail_;
+  while (tail != __atomic_load_n(&deferred_head_,__ATOMIC_ACQUIRE))
+  {
+    DeferredCall deferred_call = deferred_calls_[tail];
+    tail = (tail + 1) % DEFERRED_CALL_COUNT_MAX;
+    __atomic_store_n(&deferred_tail_,tail,__ATOMIC_RELEASE);
+    dispatcher.post(deferred_call.functor,deferred_call.arg,deferred_call.event_id);
+    ++dispatched_count;
+  }
+  return dispatched_count;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::deferredPending()
+{
+  uint8_t head = __atomic_load_n(&deferred_head_,__ATOMIC_ACQUIRE);
+  uint8_t tail = __atomic_load_n(&deferred_tail_,__ATOMIC_ACQUIRE);
+  return (head + DEFERRED_CALL_COUNT_MAX - tail) % DEFERRED_CALL_COUNT_MAX;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint16_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getDeferredOverflowCount()
+{
+  uint16_t deferred_overflow_count;
+  noInterrupts();
+  deferred_overflow_count = deferred_overflow_count_;
+  interrupts();
+  return deferred_overflow_count;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setHandlerTable(EventHandler * handlers,
+  uint8_t handler_count)
+{
+  handlers_ = handlers;
+  handler_count_ = handler_count;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setHandler(const EventId event_id,
+  uint8_t handler)
+{
+  noInterrupts();
+  if (eventIdValid(event_id) && (handler < handler_count_))
+  {
+    setHandler(event_array_[event_id.index],handler);
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setHandlers(const EventIdPair event_id_pair,
+  uint8_t handler_0,
+  uint8_t handler_1)
+{
+  setHandler(event_id_pair.event_id_0,handler_0);
+  setHandler(event_id_pair.event_id_1,handler_1);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+size_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getScheduleSize()
+{
+  return SCHEDULE_HEADER_SIZE + event_pool_.getCount(owner_) * SCHEDULE_RECORD_SIZE;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+size_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::saveSchedule(uint8_t * buffer,
+  size_t buffer_size)
+{
+  noInterrupts();
+  uint8_t record_count = event_pool_.getCount(owner_);
+  size_t schedule_size = SCHEDULE_HEADER_SIZE + record_count * SCHEDULE_RECORD_SIZE;
+  if (buffer_size < schedule_size)
+  {
+    interrupts();
+    return 0;
+  }
+  if (!scheduleSavable())
+  {
+    interrupts();
+    return 0;
+  }
+  uint32_t ticks = ticks_;
+  writeScheduleHeader(buffer,record_count);
+  uint8_t * record = buffer + SCHEDULE_HEADER_SIZE;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    if (!event_array_[event_index].free && owns(event_index))
+    {
+      writeScheduleRecord(record,event_index,ticks);
+      record += SCHEDULE_RECORD_SIZE;
+    }
+  }
+  interrupts();
+  return schedule_size;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+size_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::saveSchedule(Stream & stream)
+{
+  uint8_t header[SCHEDULE_HEADER_SIZE];
+  uint8_t record[SCHEDULE_RECORD_SIZE];
+  noInterrupts();
+  if (!scheduleSavable())
+  {
+    interrupts();
+    return 0;
+  }
+  uint8_t record_count = event_pool_.getCount(owner_);
+  uint32_t ticks = ticks_;
+  interrupts();
+  writeScheduleHeader(header,record_count);
+  size_t schedule_size = stream.write(header,SCHEDULE_HEADER_SIZE);
+  uint8_t record_index = 0;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    noInterrupts();
+    bool event_free = event_array_[event_index].free || !owns(event_index) || !eventSavable(event_array_[event_index]);
+    if (!event_free && (record_index < record_count))
+    {
+      writeScheduleRecord(record,event_index,ticks);
+    }
+    interrupts();
+    if (!event_free && (record_index < record_count))
+    {
+      schedule_size += stream.write(record,SCHEDULE_RECORD_SIZE);
+      ++record_index;
+    }
+  }
+  while (record_index < record_count)
+  {
+    memset(record,0,SCHEDULE_RECORD_SIZE);
+    record[0] = EVENT_INDEX_NONE;
+    writeScheduleCrc(record);
+    schedule_size += stream.write(record,SCHEDULE_RECORD_SIZE);
+    ++record_index;
+  }
+  return schedule_size;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::restoreSchedule(const uint8_t * buffer,
+  size_t buffer_size,
+  uint32_t elapsed)
+{
+  if (buffer_size < SCHEDULE_HEADER_SIZE)
+  {
+    return false;
+  }
+  uint8_t record_count;
+  if (!readScheduleHeader(buffer,record_count) ||
+    (buffer_size < (size_t)(SCHEDULE_HEADER_SIZE + record_count * SCHEDULE_RECORD_SIZE)))
+  {
+    return false;
+  }
+  const uint8_t * record = buffer + SCHEDULE_HEADER_SIZE;
+  for (uint8_t record_index=0; record_index<record_count; ++record_index)
+  {
+    if (!scheduleRecordValid(record + record_index * SCHEDULE_RECORD_SIZE))
+    {
+      return false;
+    }
+  }
+  noInterrupts();
+  uint32_t ticks = ticks_;
+  clearOwned();
+  for (uint8_t record_index=0; record_index<record_count; ++record_index)
+  {
+    readScheduleRecord(record,ticks,millisToTicks(elapsed));
+    record += SCHEDULE_RECORD_SIZE;
+  }
+  clearUnrestorable();
+  interrupts();
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::restoreSchedule(Stream & stream,
+  uint32_t elapsed)
+{
+  uint8_t header[SCHEDULE_HEADER_SIZE];
+  uint8_t record[SCHEDULE_RECORD_SIZE];
+  uint8_t record_count;
+  if ((stream.readBytes(header,SCHEDULE_HEADER_SIZE) != SCHEDULE_HEADER_SIZE) ||
+    !readScheduleHeader(header,record_count))
+  {
+    return false;
+  }
+  noInterrupts();
+  uint32_t ticks = ticks_;
+  clearOwned();
+  interrupts();
+  for (uint8_t record_index=0; record_index<record_count; ++record_index)
+  {
+    if ((stream.readBytes(record,SCHEDULE_RECORD_SIZE) != SCHEDULE_RECORD_SIZE) ||
+      !scheduleRecordValid(record))
+    {
+      noInterrupts();
+      clearOwned();
+      interrupts();
+      return false;
+    }
+    noInterrupts();
+    readScheduleRecord(record,ticks,millisToTicks(elapsed));
+    interrupts();
+  }
+  noInterrupts();
+  clearUnrestorable();
+  interrupts();
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+size_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::processCommands(const uint8_t * frame,
+  size_t frame_size,
+  uint8_t * response,
+  size_t response_size)
+{
+  if ((frame_size < COMMAND_FRAME_HEADER_SIZE) ||
+    (response_size < COMMAND_FRAME_HEADER_SIZE))
+  {
+    return 0;
+  }
+  const uint8_t * command = frame;
+  size_t commands_size = readValue(command,COMMAND_FRAME_HEADER_SIZE);
+  if (commands_size > (frame_size - COMMAND_FRAME_HEADER_SIZE))
+  {
+    commands_size = frame_size - COMMAND_FRAME_HEADER_SIZE;
+  }
+  const uint8_t * commands_end = command + commands_size;
+  uint8_t * result = response + COMMAND_FRAME_HEADER_SIZE;
+  uint8_t * results_end = response + response_size;
+  while ((command < commands_end) &&
+    ((results_end - result) >= COMMAND_RESULT_SIZE_MAX))
+  {
+    uint8_t op = readValue(command,1);
+    size_t command_size = 0;
+    switch (op)
+    {
+      case COMMAND_ADD:
+      {
+        command_size = COMMAND_ADD_SIZE;
+        break;
+      }
+      case COMMAND_MODIFY:
+      {
+        command_size = COMMAND_MODIFY_SIZE;
+        break;
+      }
+      case COMMAND_ENABLE:
+      case COMMAND_DISABLE:
+      case COMMAND_REMOVE:
+      {
+        command_size = COMMAND_EVENT_ID_SIZE;
+        break;
+      }
+      default:
+      {
+        writeValue(result,COMMAND_INVALID_OP,1);
+        command = commands_end;
+        continue;
+      }
+    }
+    if ((size_t)(commands_end - command) < command_size)
+    {
+      writeValue(result,COMMAND_TRUNCATED,1);
+      command = commands_end;
+      continue;
+    }
+    executeCommand(op,command,result);
+    command += command_size;
+  }
+  uint8_t * response_header = response;
+  size_t results_size = result - (response + COMMAND_FRAME_HEADER_SIZE);
+  writeValue(response_header,results_size,COMMAND_FRAME_HEADER_SIZE);
+  return COMMAND_FRAME_HEADER_SIZE + results_size;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::measureHandlerCosts(bool measure)
+{
+  measure_costs_ = measure;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventLoad EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::analyzeLoad(uint32_t budget_us,
+  uint16_t overhead_us,
+  uint32_t horizon_max_ms)
+{
+  EventLoad load;
+  uint64_t hyperperiod = 1;
+  uint32_t horizon_max = millisToTicks(horizon_max_ms);
+  uint32_t offset_max = 0;
+  noInterrupts();
+  uint32_t ticks = ticks_;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    const Event & event = event_array_[event_index];
+    LoadEvent & load_event = load_events_[event_index];
+    load_event.active = !event.free && owns(event_index) && event.enabled && !event.batched && !event.armed &&
+      (event.infinite || (event.inc < event.count));
+    if (!load_event.active)
+    {
+      continue;
+    }
+    load_event.time = event.time - ticks;
+    load_event.period = event.period;
+    load_event.period_remainder = event.period_remainder;
+    load_event.period_denominator = event.period_denominator;
+    load_event.phase = event.phase;
+    load_event.remaining = event.count - event.inc;
+    load_event.infinite = event.infinite;
+    load_event.rearm = event.rearm;
+    load_event.cost_us = 0;
+    load_event.events = 0;
+    uint8_t batch_index = event_index;
+    while (batch_index < EVENT_COUNT_MAX)
+    {
+      const Event & batch_event = event_array_[batch_index];
+      if ((batch_index == event_index) || batch_event.enabled)
+      {
+        load_event.cost_us += overhead_us;
+        ++load_event.events;
+        if ((batch_event.action == EVENT_ACTION_FUNCTOR) && !batch_event.deferred)
+        {
+          if (batch_event.handler < handler_count_)
+          {
+            load_event.cost_us += handlers_[batch_event.handler].cost_us;
+          }
+          else
+          {
+            ++load.unknown_cost_count;
+          }
+        }
+      }
+      batch_index = batch_event.batch_next;
+      if ((batch_index < EVENT_COUNT_MAX) && !event_array_[batch_index].batched)
+      {
+        batch_index = EVENT_INDEX_NONE;
+      }
+    }
+    if ((load_event.time > 0) && ((uint32_t)load_event.time > offset_max))
+    {
+      offset_max = load_event.time;
+    }
+    uint64_t cycle = (uint64_t)event.period * event.period_denominator + event.period_remainder;
+    if (cycle == 0)
+    {
+      cycle = 1;
+    }
+    if (cycle > horizon_max)
+    {
+      hyperperiod = (uint64_t)horizon_max + 1;
+    }
+    else if (hyperperiod <= horizon_max)
+    {
+      uint64_t a = hyperperiod;
+      uint64_t b = cycle;
+      while (b != 0)
+      {
+        uint64_t r = a % b;
+        a = b;
+        b = r;
+      }
+      hyperperiod = (hyperperiod / a) * cycle;
+    }
+  }
+  interrupts();
+
+  load.horizon = horizon_max;
+  if ((offset_max + hyperperiod) < horizon_max)
+  {
+    load.horizon = offset_max + hyperperiod;
+  }
+  uint32_t cost_total_us = 0;
+  while (true)
+  {
+    uint32_t tick_next = 0xFFFFFFFF;
+    for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+    {
+      const LoadEvent & load_event = load_events_[event_index];
+      if (load_event.active)
+      {
+        uint32_t tick = (load_event.time > 1) ? load_event.time : 1;
+        if (tick < tick_next)
+        {
+          tick_next = tick;
+        }
+      }
+    }
+    if (tick_next > load.horizon)
+    {
+      break;
+    }
+    uint32_t tick_cost_us = 0;
+    uint8_t tick_events = 0;
+    for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+    {
+      LoadEvent & load_event = load_events_[event_index];
+      if (!load_event.active || (((load_event.time > 1) ? (uint32_t)load_event.time : 1) != tick_next))
+      {
+        continue;
+      }
+      tick_cost_us += load_event.cost_us;
+      tick_events += load_event.events;
+      if ((load_event.period == 0) && (load_event.period_remainder == 0))
+      {
+        load_event.time = tick_next + 1;
+      }
+      while (load_event.time <= (int32_t)tick_next)
+      {
+        load_event.time += load_event.period;
+        if (load_event.phase >= (load_event.period_denominator - load_event.period_remainder))
+        {
+          load_event.phase -= (load_event.period_denominator - load_event.period_remainder);
+          ++load_event.time;
+        }
+        else
+        {
+          load_event.phase += load_event.period_remainder;
+        }
+      }
+      if ((!load_event.infinite && (--load_event.remaining == 0)) || load_event.rearm)
+      {
+        load_event.active = false;
+      }
+    }
+    ++load.tick_count;
+    cost_total_us += tick_cost_us;
+    if (tick_cost_us > load.cost_max_us)
+    {
+      load.cost_max_us = tick_cost_us;
+      load.cost_max_tick = tick_next;
+    }
+    if (tick_events > load.events_max)
+    {
+      load.events_max = tick_events;
+      load.events_max_tick = tick_next;
+    }
+    if (tick_cost_us > budget_us)
+    {
+      if (load.overrun_count == 0)
+      {
+        load.overrun_first_tick = tick_next;
+      }
+      ++load.overrun_count;
+    }
+  }
+  if (load.horizon > 0)
+  {
+    load.cost_average_us = cost_total_us / load.horizon;
+  }
+  return load;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addSequenceUsingDelay(const Functor1<int> & functor,
+  EventSequenceRecord * records,
+  uint8_t record_count_max,
+  uint32_t delay)
+{
+  EventId event_id;
+  if ((records == 0) || (record_count_max < 2))
+  {
+    return event_id;
+  }
+  noInterrupts();
+  if (sequence_event_index_ < EVENT_COUNT_MAX)
+  {
+    interrupts();
+    return event_id;
+  }
+  event_id = addEventUsingTicksUnlocked(makeFunctor((Functor1<int> *)0,*this,&EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::playSequence),
+    getTicksUnlocked() + millisToTicks(delay),
+    TickPeriod(),
+    -1,
+    -1);
+  if (event_id.index < EVENT_COUNT_MAX)
+  {
+    Event & event = event_array_[event_id.index];
+    event.rearm = true;
+    event.armed = true;
+    event.enabled = true;
+    sequence_functor_ = functor;
+    sequence_records_ = records;
+    sequence_record_count_max_ = record_count_max;
+    sequence_head_ = 0;
+    sequence_tail_ = 0;
+    sequence_underrun_count_ = 0;
+    sequence_remainder_us_ = 0;
+    sequence_event_index_ = event_id.index;
+  }
+  interrupts();
+  return event_id;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setSequenceLowWatermark(uint8_t low_watermark,
+  const Functor1<int> & functor)
+{
+  noInterrupts();
+  sequence_low_watermark_ = low_watermark;
+  sequence_functor_low_watermark_ = functor;
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::pushSequence(uint32_t delta_us,
+  int arg)
+{
+  noInterrupts();
+  if (sequence_event_index_ >= EVENT_COUNT_MAX)
+  {
+    interrupts();
+    return false;
+  }
+  uint8_t head_next = (sequence_head_ + 1) % sequence_record_count_max_;
+  if (head_next == sequence_tail_)
+  {
+    interrupts();
+    return false;
+  }
+  sequence_records_[sequence_head_].delta_us = delta_us;
+  sequence_records_[sequence_head_].arg = arg;
+  sequence_head_ = head_next;
+  Event & event = event_array_[sequence_event_index_];
+  if (event.armed)
+  {
+    if (timeReached(event.time))
+    {
+      event.time = ticks_;
+    }
+    scheduleSequence(event);
+  }
+  interrupts();
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getSequenceSpace()
+{
+  noInterrupts();
+  uint8_t space = 0;
+  if (sequence_event_index_ < EVENT_COUNT_MAX)
+  {
+    space = sequence_record_count_max_ - 1 - sequencePending();
+  }
+  interrupts();
+  return space;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint16_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getSequenceUnderrunCount()
+{
+  noInterrupts();
+  uint16_t underrun_count = sequence_underrun_count_;
+  interrupts();
+  return underrun_count;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::poll()
+{
+  uint32_t time_us = micros();
+  uint32_t elapsed_us = (time_us - poll_time_us_) + poll_remainder_us_;
+  poll_time_us_ = time_us;
+  poll_remainder_us_ = elapsed_us % TICK_PERIOD_US;
+  uint32_t tick_count = elapsed_us / TICK_PERIOD_US;
+  if (tick_count == 0)
+  {
+    return 0;
+  }
+  advanceTicks(tick_count);
+  uint32_t ticks = getTicks();
+  uint32_t lag = 0;
+  uint8_t due[EVENT_COUNT_MAX];
+  uint8_t due_count = 0;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    if (eventDue(event_index))
+    {
+      uint8_t position = due_count++;
+      while ((position > 0) &&
+        ((int32_t)(event_array_[event_index].time - event_array_[due[position - 1]].time) < 0))
+      {
+        due[position] = due[position - 1];
+        --position;
+      }
+      due[position] = event_index;
+    }
+  }
+  for (uint8_t due_index=0; due_index<due_count; ++due_index)
+  {
+    uint8_t event_index = due[due_index];
+    if (!eventDue(event_index))
+    {
+      continue;
+    }
+    uint32_t event_lag = ticks - event_array_[event_index].time;
+    if (event_lag > lag)
+    {
+      lag = event_lag;
+    }
+    process(event_index,true);
+  }
+  uint32_t lag_us = lag * TICK_PERIOD_US + poll_remainder_us_;
+  if (lag_us > poll_lag_max_us_)
+  {
+    poll_lag_max_us_ = lag_us;
+  }
+  return lag_us;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getPollLagMax()
+{
+  return poll_lag_max_us_;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventPool<EVENT_COUNT_MAX> & EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getEventPool()
+{
+  return event_pool_;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setQuota(uint8_t quota)
+{
+  noInterrupts();
+  event_pool_.setQuota(owner_,quota);
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getHighWatermark()
+{
+  return event_pool_.getHighWatermark(owner_);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+Event EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getEvent(const EventId event_id)
+{
+  uint8_t event_index = event_id.index;
+  if (event_index < EVENT_COUNT_MAX)
+  {
+    return event_array_[event_index];
+  }
+  else
+  {
+    return Event();
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+Event EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getEvent(uint8_t event_index)
+{
+  if (event_index < EVENT_COUNT_MAX)
+  {
+    return event_array_[event_index];
+  }
+  else
+  {
+    return Event();
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setEventArgToEventIndex(const EventId event_id)
+{
+  noInterrupts();
+  if (eventIdValid(event_id))
+  {
+    event_array_[event_id.index].arg = event_id.index;
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::eventsActive()
+{
+  uint8_t events_active = 0;
+  for (uint8_t event_index=0; event_index<event_array_.size(); ++event_index)
+  {
+    if ((!event_array_[event_index].free) && event_array_[event_index].enabled && owns(event_index))
+    {
+      ++events_active;
+    }
+  }
+  return events_active;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::eventsAvailable()
+{
+  return event_pool_.getAvailable(owner_);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+Array<Event,EVENT_COUNT_MAX> EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getEventArray()
+{
+  return event_array_;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::startTimer()
+{
+  noInterrupts();
+  instance_ = this;
+  EVENT_TIMER::start(*this,timer_number_,TICK_PERIOD_US);
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::isr()
+{
+  instance_->update();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::millisToTicks(uint32_t ms)
+{
+  uint64_t ticks = (uint64_t)ms * TICKS_PER_MILLI_SEC;
+  if (ticks > TICKS_DELAY_MAX)
+  {
+    return TICKS_DELAY_MAX;
+  }
+  return ticks;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::microsToTicks(uint32_t us)
+{
+  uint32_t ticks = us / TICK_PERIOD_US;
+  if (ticks > TICKS_DELAY_MAX)
+  {
+    return TICKS_DELAY_MAX;
+  }
+  return ticks;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::timeToTicks(uint32_t time)
+{
+  return (uint64_t)time * TICKS_PER_MILLI_SEC;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+typename EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::TickPeriod EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::periodFromMillis(const EventPeriod period)
+{
+  TickPeriod tick_period;
+  uint16_t denominator = period.denominator;
+  if (denominator == 0)
+  {
+    denominator = 1;
+  }
+  uint32_t remainder_ms = period.numerator_ms % denominator;
+  tick_period.ticks = millisToTicks(period.numerator_ms / denominator);
+  tick_period.ticks += millisToTicks(remainder_ms) / denominator;
+  tick_period.remainder = millisToTicks(remainder_ms) % denominator;
+  tick_period.denominator = denominator;
+  return tick_period;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+typename EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::TickPeriod EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::periodFromMicros(uint32_t period_us)
+{
+  TickPeriod tick_period;
+  tick_period.ticks = period_us / TICK_PERIOD_US;
+  tick_period.remainder = period_us % TICK_PERIOD_US;
+  tick_period.denominator = TICK_PERIOD_US;
+  if (tick_period.ticks >= TICKS_DELAY_MAX)
+  {
+    tick_period.ticks = TICKS_DELAY_MAX;
+    tick_period.remainder = 0;
+  }
+  return tick_period;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEventUsingTicks(const Functor1<int> & functor,
+  uint32_t time,
+  const TickPeriod period,
+  int32_t count,
+  int arg)
+{
+  noInterrupts();
+  EventId event_id = addEventUsingTicksUnlocked(functor,
+    time,
+    period,
+    count,
+    arg);
+  interrupts();
+  return event_id;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addEventUsingTicksUnlocked(const Functor1<int> & functor,
+  uint32_t time,
+  const TickPeriod period,
+  int32_t count,
+  int arg)
+{
+  uint32_t time_start = getTicksUnlocked();
+  uint8_t event_index = event_pool_.allocate(owner_);
+  if (event_index < EVENT_COUNT_MAX)
+  {
+    Event & event = event_array_[event_index];
+    event.functor = functor;
+    event.time_start = time_start;
+    event.time = time;
+    event.enabled = false;
+    event.infinite = (count < 0);
+    event.period = period.ticks;
+    event.period_remainder = period.remainder;
+    event.period_denominator = period.denominator;
+    event.phase = 0;
+    event.count = (count < 0) ? 0 : count;
+    event.inc = 0;
+    event.arg = arg;
+    event.groups = 0;
+    event.action = EVENT_ACTION_FUNCTOR;
+    event.port_register = 0;
+    event.port_bit_mask = 0;
+    event.pin = PIN_NONE;
+    event.batched = false;
+    event.batch_next = EVENT_INDEX_NONE;
+    event.armed = false;
+    event.rearm = false;
+    event.trigger_delay = 0;
+    event.deferred = false;
+    event.handler = HANDLER_NONE;
+    event.functor_start = functor_dummy_;
+    event.functor_stop = functor_dummy_;
+    event.free = false;
+  }
+  EventId event_id;
+  event_id.index = event_index;
+  event_id.time_start = time_start;
+  return event_id;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventIdPair EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addPwmUsingTicks(const Functor1<int> & functor_0,
+  const Functor1<int> & functor_1,
+  uint32_t time,
+  TickPeriod period,
+  uint32_t on_duration,
+  int32_t count,
+  int arg)
+{
+  EventIdPair event_id_pair;
+  if ((period.ticks == 0) && (period.remainder == 0) && (on_duration == 0))
+  {
+    return event_id_pair;
+  }
+  if (period.ticks < on_duration)
+  {
+    period = TickPeriod();
+    period.ticks = on_duration;
+  }
+  noInterrupts();
+  if ((on_duration > 0) &&
+    ((on_duration < period.ticks) || (period.remainder > 0)))
+  {
+    event_id_pair.event_id_0 = addEventUsingTicksUnlocked(functor_0,
+      time,
+      period,
+      count,
+      arg);
+    event_id_pair.event_id_1 = addEventUsingTicksUnlocked(functor_1,
+      time + on_duration,
+      period,
+      count,
+      arg);
+  }
+  else if (on_duration == 0)
+  {
+    event_id_pair.event_id_0 = addEventUsingTicksUnlocked(functor_1,
+      time,
+      period,
+      count,
+      arg);
+  }
+  else
+  {
+    event_id_pair.event_id_0 = addEventUsingTicksUnlocked(functor_0,
+      time,
+      period,
+      count,
+      arg);
+  }
+  interrupts();
+  return event_id_pair;
+}
+
+#if defined(EVENT_CONTROLLER_COROUTINES)
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::allocateTask(EventTaskPromise & promise)
+{
+  noInterrupts();
+  EventId event_id = addEventUsingTicksUnlocked(makeFunctor((Functor1<int> *)0,*this,&EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::resumeTask),
+    ticks_,
+    TickPeriod(),
+    -1,
+    -1);
+  bool allocated = (event_id.index < EVENT_COUNT_MAX);
+  if (allocated)
+  {
+    Event & event = event_array_[event_id.index];
+    event.arg = event_id.index;
+    event.rearm = true;
+    event.armed = true;
+    event.deferred = true;
+    event.enabled = true;
+    event.functor_stop = makeFunctor((Functor1<int> *)0,promise,&EventTaskPromise::destroy);
+    task_promises_[event_id.index] = &promise;
+    promise.event_index = event_id.index;
+    promise.functor_release = makeFunctor((Functor1<int> *)0,*this,&EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::releaseTask);
+  }
+  interrupts();
+  return allocated;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::scheduleTask(EventTaskPromise & promise,
+  uint32_t time)
+{
+  noInterrupts();
+  bool scheduled = (promise.event_index >= 0) &&
+    (promise.event_index < EVENT_COUNT_MAX) &&
+    (task_promises_[promise.event_index] == &promise);
+  if (scheduled)
+  {
+    Event & event = event_array_[promise.event_index];
+    event.time = time;
+    event.armed = false;
+    promise.running = false;
+  }
+  interrupts();
+  return scheduled;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::resumeTask(int event_index)
+{
+  if ((event_index < 0) || (event_index >= EVENT_COUNT_MAX))
+  {
+    return;
+  }
+  noInterrupts();
+  EventTaskPromise * promise = task_promises_[event_index];
+  bool resumable = promise && event_array_[event_index].armed && !promise->running;
+  if (resumable)
+  {
+    promise->running = true;
+  }
+  interrupts();
+  if (resumable)
+  {
+    promise->resume();
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::releaseTask(int event_index)
+{
+  if ((event_index >= 0) && (event_index < EVENT_COUNT_MAX))
+  {
+    remove((uint8_t)event_index);
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::detachTask(uint8_t event_index)
+{
+  EventTaskPromise * promise = task_promises_[event_index];
+  if (promise)
+  {
+    promise->event_index = -1;
+    if (promise->running)
+    {
+      event_array_[event_index].functor_stop = functor_dummy_;
+    }
+    task_promises_[event_index] = 0;
+  }
+}
+
+#endif
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::setHandler(Event & event,
+  uint8_t handler)
+{
+  event.handler = handler;
+  event.functor = handlers_[handler].functor;
+  event.functor_start = handlers_[handler].functor_start;
+  event.functor_stop = handlers_[handler].functor_stop;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::writeValue(uint8_t * & buffer,
+  uint32_t value,
+  uint8_t byte_count)
+{
+  for (uint8_t byte_index=0; byte_index<byte_count; ++byte_index)
+  {
+    *buffer++ = value >> (8 * byte_index);
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::readValue(const uint8_t * & buffer,
+  uint8_t byte_count)
+{
+  uint32_t value = 0;
+  for (uint8_t byte_index=0; byte_index<byte_count; ++byte_index)
+  {
+    value |= (uint32_t)(*buffer++) << (8 * byte_index);
+  }
+  return value;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::writeScheduleHeader(uint8_t * header,
+  uint8_t record_count)
+{
+  writeValue(header,SCHEDULE_MAGIC,2);
+  writeValue(header,SCHEDULE_VERSION,1);
+  writeValue(header,record_count,1);
+  writeValue(header,TICK_PERIOD_US,2);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::readScheduleHeader(const uint8_t * header,
+  uint8_t & record_count)
+{
+  if ((readValue(header,2) != SCHEDULE_MAGIC) ||
+    (readValue(header,1) != SCHEDULE_VERSION))
+  {
+    return false;
+  }
+  record_count = readValue(header,1);
+  return (readValue(header,2) == TICK_PERIOD_US) && (record_count <= EVENT_COUNT_MAX);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::eventSavable(const Event & event)
+{
+  return (event.action == EVENT_ACTION_FUNCTOR) || (event.pin != PIN_NONE);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::scheduleSavable()
+{
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    if (!event_array_[event_index].free && owns(event_index) && !eventSavable(event_array_[event_index]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::clearUnrestorable()
+{
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    const Event & event = event_array_[event_index];
+    if (!event.free && owns(event_index) &&
+      (event.rearm || event.armed) &&
+      (event.handler == HANDLER_NONE) &&
+      (event.action == EVENT_ACTION_FUNCTOR))
+    {
+      clear(event_index);
+    }
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::clearOwned()
+{
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    clear(event_index);
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint16_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::scheduleCrc(const uint8_t * buffer,
+  size_t buffer_size)
+{
+  uint16_t crc = 0xFFFF;
+  for (size_t byte_index=0; byte_index<buffer_size; ++byte_index)
+  {
+    crc ^= (uint16_t)buffer[byte_index] << 8;
+    for (uint8_t bit=0; bit<8; ++bit)
+    {
+      crc = (crc & 0x8000) ? ((crc << 1) ^ SCHEDULE_CRC_POLYNOMIAL) : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::writeScheduleCrc(uint8_t * record)
+{
+  uint16_t crc = scheduleCrc(record,SCHEDULE_RECORD_DATA_SIZE);
+  record += SCHEDULE_RECORD_DATA_SIZE;
+  writeValue(record,crc,SCHEDULE_CRC_SIZE);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::scheduleRecordValid(const uint8_t * record)
+{
+  uint16_t crc = scheduleCrc(record,SCHEDULE_RECORD_DATA_SIZE);
+  record += SCHEDULE_RECORD_DATA_SIZE;
+  return readValue(record,SCHEDULE_CRC_SIZE) == crc;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::writeScheduleRecord(uint8_t * record,
+  uint8_t event_index,
+  uint32_t ticks)
+{
+  const Event & event = event_array_[event_index];
+  uint8_t * record_start = record;
+  uint8_t flags = 0;
+  flags |= event.enabled << SCHEDULE_FLAG_ENABLED;
+  flags |= event.infinite << SCHEDULE_FLAG_INFINITE;
+  flags |= event.armed << SCHEDULE_FLAG_ARMED;
+  flags |= event.rearm << SCHEDULE_FLAG_REARM;
+  flags |= event.deferred << SCHEDULE_FLAG_DEFERRED;
+  flags |= event.batched << SCHEDULE_FLAG_BATCHED;
+  writeValue(record,event_index,1);
+  writeValue(record,flags,1);
+  writeValue(record,event.handler,1);
+  writeValue(record,event.groups,1);
+  writeValue(record,event.action,1);
+  writeValue(record,event.batch_next,1);
+  writeValue(record,event.time - ticks,4);
+  writeValue(record,event.period,4);
+  writeValue(record,event.period_remainder,2);
+  writeValue(record,event.period_denominator,2);
+  writeValue(record,event.phase,2);
+  writeValue(record,event.count,2);
+  writeValue(record,event.inc,2);
+  writeValue(record,event.arg,4);
+  writeValue(record,event.trigger_delay,4);
+  writeValue(record,event.time_start,4);
+  writeValue(record,event.pin,1);
+  writeScheduleCrc(record_start);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::readScheduleRecord(const uint8_t * record,
+  uint32_t ticks,
+  uint32_t elapsed)
+{
+  uint8_t event_index = readValue(record,1);
+  if ((event_index >= EVENT_COUNT_MAX) || !event_pool_.claim(event_index,owner_))
+  {
+    return;
+  }
+  Event & event = event_array_[event_index];
+  uint8_t flags = readValue(record,1);
+  uint8_t handler = readValue(record,1);
+  event.groups = readValue(record,1);
+  event.action = readValue(record,1);
+  event.batch_next = readValue(record,1);
+  event.time = ticks + readValue(record,4) - elapsed;
+  event.period = readValue(record,4);
+  event.period_remainder = readValue(record,2);
+  event.period_denominator = readValue(record,2);
+  event.phase = readValue(record,2);
+  event.count = readValue(record,2);
+  event.inc = readValue(record,2);
+  event.arg = (int32_t)readValue(record,4);
+  event.trigger_delay = readValue(record,4);
+  event.time_start = readValue(record,4);
+  event.pin = readValue(record,1);
+  event.enabled = flags & (1 << SCHEDULE_FLAG_ENABLED);
+  event.infinite = flags & (1 << SCHEDULE_FLAG_INFINITE);
+  event.armed = flags & (1 << SCHEDULE_FLAG_ARMED);
+  event.rearm = flags & (1 << SCHEDULE_FLAG_REARM);
+  event.deferred = flags & (1 << SCHEDULE_FLAG_DEFERRED);
+  event.batched = flags & (1 << SCHEDULE_FLAG_BATCHED);
+  if (event.action != EVENT_ACTION_FUNCTOR)
+  {
+    event.port_register = (event.pin == PIN_NONE) ? 0 : (volatile EventPortRegister *)portOutputRegister(digitalPinToPort(event.pin));
+    event.port_bit_mask = (event.pin == PIN_NONE) ? 0 : digitalPinToBitMask(event.pin);
+    if (!event.port_register)
+    {
+      event.pin = PIN_NONE;
+      event.action = EVENT_ACTION_FUNCTOR;
+    }
+  }
+  if (handler < handler_count_)
+  {
+    setHandler(event,handler);
+  }
+  else if (event.action == EVENT_ACTION_FUNCTOR)
+  {
+    event.enabled = false;
+  }
+  event.free = false;
+  if (event.armed || event.batched)
+  {
+    return;
+  }
+  catchUp(event,ticks);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::catchUp(Event & event,
+  uint32_t ticks)
+{
+  uint16_t denominator = (event.period_denominator > 0) ? event.period_denominator : 1;
+  uint64_t period_scaled = (uint64_t)event.period * denominator + event.period_remainder;
+  if ((period_scaled == 0) ||
+    ((int32_t)(ticks - event.time) <= 0) ||
+    (!event.infinite && (event.inc >= event.count)))
+  {
+    return;
+  }
+  uint64_t lag_scaled = (uint64_t)(ticks - event.time) * denominator - event.phase;
+  uint64_t period_count = (lag_scaled + period_scaled - 1) / period_scaled;
+  if (!event.infinite && (period_count > (uint64_t)(event.count - event.inc)))
+  {
+    period_count = event.count - event.inc;
+  }
+  uint64_t phase_total = event.phase + period_count * event.period_remainder;
+  event.time += period_count * event.period + phase_total / denominator;
+  event.phase = phase_total % denominator;
+  event.inc += period_count;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::executeCommand(uint8_t op,
+  const uint8_t * command,
+  uint8_t * & result)
+{
+  if (op == COMMAND_ADD)
+  {
+    uint8_t handler = readValue(command,1);
+    uint32_t delay = readValue(command,4);
+    uint32_t period_ms = readValue(command,4);
+    uint16_t period_denominator = readValue(command,2);
+    uint16_t count = readValue(command,2);
+    int32_t arg = readValue(command,4);
+    bool enabled = readValue(command,1);
+    if (handler >= handler_count_)
+    {
+      writeValue(result,COMMAND_INVALID_HANDLER,1);
+      return;
+    }
+    if (period_denominator == 0)
+    {
+      writeValue(result,COMMAND_INVALID_PERIOD,1);
+      return;
+    }
+    noInterrupts();
+    EventId event_id = addEventUsingTicksUnlocked(handlers_[handler].functor,
+      getTicksUnlocked() + millisToTicks(delay),
+      periodFromMillis(EventPeriod(period_ms,period_denominator)),
+      (count == COMMAND_COUNT_INFINITE) ? -1 : (int32_t)count,
+      arg);
+    if (event_id.index >= EVENT_COUNT_MAX)
+    {
+      interrupts();
+      writeValue(result,COMMAND_FULL,1);
+      return;
+    }
+    setHandler(event_array_[event_id.index],handler);
+    event_array_[event_id.index].enabled = enabled;
+    interrupts();
+    writeValue(result,COMMAND_OK,1);
+    writeValue(result,event_id.index,1);
+    writeValue(result,event_id.time_start,4);
+    return;
+  }
+  EventId event_id;
+  event_id.index = readValue(command,1);
+  event_id.time_start = readValue(command,4);
+  noInterrupts();
+  bool event_valid = eventIdValid(event_id);
+  interrupts();
+  if (!event_valid)
+  {
+    writeValue(result,COMMAND_INVALID_EVENT,1);
+    return;
+  }
+  switch (op)
+  {
+    case COMMAND_MODIFY:
+    {
+      uint8_t handler = readValue(command,1);
+      int32_t arg = readValue(command,4);
+      if ((handler >= handler_count_) && (handler != HANDLER_NONE))
+      {
+        writeValue(result,COMMAND_INVALID_HANDLER,1);
+        return;
+      }
+      noInterrupts();
+      event_valid = eventIdValid(event_id);
+      if (event_valid)
+      {
+        if (handler != HANDLER_NONE)
         {
-          event.time += event.period_ms;
+          setHandler(event_array_[event_id.index],handler);
         }
-        if (event.functor_start && (event.inc == 0))
+        event_array_[event_id.index].arg = arg;
+      }
+      interrupts();
+      if (!event_valid)
+      {
+        writeValue(result,COMMAND_INVALID_EVENT,1);
+        return;
+      }
+      break;
+    }
+    case COMMAND_ENABLE:
+    {
+      enable(event_id);
+      break;
+    }
+    case COMMAND_DISABLE:
+    {
+      disable(event_id);
+      break;
+    }
+    case COMMAND_REMOVE:
+    {
+      remove(event_id);
+      break;
+    }
+  }
+  writeValue(result,COMMAND_OK,1);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint8_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::sequencePending()
+{
+  return (sequence_head_ + sequence_record_count_max_ - sequence_tail_) % sequence_record_count_max_;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::scheduleSequence(Event & event)
+{
+  if (sequence_head_ == sequence_tail_)
+  {
+    return false;
+  }
+  uint32_t delta_us = sequence_records_[sequence_tail_].delta_us + sequence_remainder_us_;
+  sequence_remainder_us_ = delta_us % TICK_PERIOD_US;
+  event.time += microsToTicks(delta_us);
+  __asm__ __volatile__ ("" ::: "memory");
+  event.armed = false;
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::playSequence(int)
+{
+  if ((sequence_event_index_ >= EVENT_COUNT_MAX) || (sequence_head_ == sequence_tail_))
+  {
+    return;
+  }
+  Event & event = event_array_[sequence_event_index_];
+  int arg = sequence_records_[sequence_tail_].arg;
+  sequence_tail_ = (sequence_tail_ + 1) % sequence_record_count_max_;
+  scheduleSequence(event);
+  if (sequence_functor_)
+  {
+    sequence_functor_(arg);
+  }
+  uint8_t pending = sequencePending();
+  if (sequence_functor_low_watermark_ && (pending == sequence_low_watermark_))
+  {
+    sequence_functor_low_watermark_(pending);
+  }
+  if ((sequence_event_index_ < EVENT_COUNT_MAX) && event.armed)
+  {
+    sequence_underrun_count_ = sequence_underrun_count_ + 1;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::owns(uint8_t event_index)
+{
+  return event_pool_.owns(owner_,event_index);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::eventIdValid(const EventId event_id)
+{
+  uint8_t event_index = event_id.index;
+  return (event_index < EVENT_COUNT_MAX) &&
+    (event_array_[event_index].time_start == event_id.time_start) &&
+    !event_array_[event_index].free &&
+    owns(event_index);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getOffsetTime(const EventId event_id_origin,
+  uint32_t offset,
+  uint32_t & time)
+{
+  noInterrupts();
+  bool valid = eventIdValid(event_id_origin);
+  if (valid)
+  {
+    uint32_t time_origin = event_array_[event_id_origin.index].time;
+    int64_t ahead = (int64_t)(int32_t)(time_origin - ticks_) + offset;
+    valid = (ahead <= TICKS_DELAY_MAX);
+    time = time_origin + offset;
+  }
+  interrupts();
+  return valid;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::detach(uint8_t event_index,
+  Functor1<int> & functor_stop,
+  int & arg)
+{
+  Event & event = event_array_[event_index];
+  if (event.free || !owns(event_index))
+  {
+    return;
+  }
+#if defined(EVENT_CONTROLLER_COROUTINES)
+  detachTask(event_index);
+#endif
+  functor_stop = event.functor_stop;
+  arg = event.arg;
+  if (event.deferred && functor_stop && defer(functor_stop,arg,event_index))
+  {
+    functor_stop = functor_dummy_;
+  }
+  clear(event_index);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+EventId EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::addTimeoutUsingTicks(const Functor1<int> & functor,
+  uint32_t timeout,
+  int arg)
+{
+  if (timeout == 0)
+  {
+    timeout = 1;
+  }
+  else if (timeout > TICKS_DELAY_MAX)
+  {
+    timeout = TICKS_DELAY_MAX;
+  }
+  noInterrupts();
+  EventId event_id = addEventUsingTicksUnlocked(functor,
+    getTicksUnlocked() + timeout,
+    TickPeriod(),
+    -1,
+    arg);
+  if (event_id.index < EVENT_COUNT_MAX)
+  {
+    Event & event = event_array_[event_id.index];
+    event.trigger_delay = timeout;
+    event.rearm = true;
+    event.enabled = true;
+  }
+  interrupts();
+  return event_id;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+uint32_t EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::getTicksUnlocked()
+{
+  uint32_t ticks;
+  do
+  {
+    ticks = ticks_;
+  } while (ticks != ticks_);
+  return ticks;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::arm(const EventId event_id,
+  uint32_t delay)
+{
+  noInterrupts();
+  if (eventIdValid(event_id))
+  {
+    event_array_[event_id.index].trigger_delay = delay;
+    event_array_[event_id.index].armed = true;
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::arm(const EventIdPair event_id_pair,
+  uint32_t delay)
+{
+  noInterrupts();
+  if (eventIdValid(event_id_pair.event_id_0))
+  {
+    Event & event_0 = event_array_[event_id_pair.event_id_0.index];
+    event_0.trigger_delay = delay;
+    event_0.armed = true;
+    if (eventIdValid(event_id_pair.event_id_1))
+    {
+      Event & event_1 = event_array_[event_id_pair.event_id_1.index];
+      event_1.trigger_delay = delay + (event_1.time - event_0.time);
+      event_1.armed = true;
+    }
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::trigger(uint8_t event_index,
+  uint32_t ticks)
+{
+  Event & event = event_array_[event_index];
+  if (event.armed)
+  {
+    event.time = ticks + event.trigger_delay;
+    __asm__ __volatile__ ("" ::: "memory");
+    event.armed = false;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::timeReached(uint32_t time)
+{
+  return (int32_t)(ticks_ - time) >= 0;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::coalesce(uint8_t event_index_leader,
+  uint8_t event_index)
+{
+  Event & event_leader = event_array_[event_index_leader];
+  Event & event = event_array_[event_index];
+  if (event_leader.batched ||
+    event.batched ||
+    (event.batch_next < EVENT_COUNT_MAX) ||
+    (event_leader.time != event.time) ||
+    (event_leader.period != event.period) ||
+    (event_leader.period_remainder != event.period_remainder) ||
+    (event_leader.period_denominator != event.period_denominator) ||
+    (event_leader.phase != event.phase) ||
+    (event_leader.infinite != event.infinite) ||
+    (event_leader.count != event.count) ||
+    (event_leader.inc != event.inc))
+  {
+    return false;
+  }
+  uint8_t event_index_tail = event_index_leader;
+  while (event_array_[event_index_tail].batch_next < EVENT_COUNT_MAX)
+  {
+    event_index_tail = event_array_[event_index_tail].batch_next;
+  }
+  event.batched = true;
+  event_array_[event_index_tail].batch_next = event_index;
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::unlinkBatch(uint8_t event_index)
+{
+  Event & event = event_array_[event_index];
+  if (event.batched)
+  {
+    for (uint8_t event_index_previous=0; event_index_previous<EVENT_COUNT_MAX; ++event_index_previous)
+    {
+      if (event_array_[event_index_previous].batch_next == event_index)
+      {
+        event_array_[event_index_previous].batch_next = event.batch_next;
+        break;
+      }
+    }
+  }
+  else if (event.batch_next < EVENT_COUNT_MAX)
+  {
+    event_array_[event.batch_next].batched = false;
+  }
+  event.batched = false;
+  event.batch_next = EVENT_INDEX_NONE;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::removeBatch(uint8_t event_index)
+{
+  uint8_t batch_index = event_array_[event_index].batch_next;
+  remove(event_index);
+  while (batch_index < EVENT_COUNT_MAX)
+  {
+    uint8_t batch_index_next = event_array_[batch_index].batch_next;
+    remove(batch_index);
+    batch_index = batch_index_next;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::defer(const Functor1<int> & functor,
+  int arg,
+  uint8_t event_index)
+{
+  uint8_t head = deferred_head_;
+  uint8_t head_next = (head + 1) % DEFERRED_CALL_COUNT_MAX;
+  if (head_next == __atomic_load_n(&deferred_tail_,__ATOMIC_ACQUIRE))
+  {
+    return false;
+  }
+  deferred_calls_[head].functor = functor;
+  deferred_calls_[head].arg = arg;
+  deferred_calls_[head].event_id.index = event_index;
+  deferred_calls_[head].event_id.time_start = event_array_[event_index].time_start;
+  __atomic_store_n(&deferred_head_,head_next,__ATOMIC_RELEASE);
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::invoke(const Functor1<int> & functor,
+  const Event & event)
+{
+  if (!event.deferred)
+  {
+    functor(event.arg);
+    return;
+  }
+  if ((deferredPending() >= (EVENT_CONTROLLER_DEFERRED_COUNT_MAX - 1)) ||
+    !defer(functor,event.arg,&event - &event_array_[0]))
+  {
+    deferred_overflow_count_ = deferred_overflow_count_ + 1;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::dispatch(Event & event)
+{
+  if (event.functor_start && (event.inc == 0))
+  {
+    invoke(event.functor_start,event);
+  }
+  switch (event.action)
+  {
+    case EVENT_ACTION_PIN_HIGH:
+      *event.port_register = *event.port_register | event.port_bit_mask;
+      break;
+    case EVENT_ACTION_PIN_LOW:
+      *event.port_register = *event.port_register & ~event.port_bit_mask;
+      break;
+    case EVENT_ACTION_PIN_TOGGLE:
+      *event.port_register = *event.port_register ^ event.port_bit_mask;
+      break;
+    default:
+      if (event.functor)
+      {
+        if (measure_costs_ && (event.handler < handler_count_) && !event.deferred)
         {
-          event.functor_start(event.arg);
+          uint32_t time_start_us = micros();
+          invoke(event.functor,event);
+          uint32_t cost_us = micros() - time_start_us;
+          if (cost_us > 0xFFFF)
+          {
+            cost_us = 0xFFFF;
+          }
+          if (cost_us > handlers_[event.handler].cost_us)
+          {
+            handlers_[event.handler].cost_us = cost_us;
+          }
         }
-        if (event.functor)
+        else
         {
-          event.functor(event.arg);
+          invoke(event.functor,event);
         }
-        ++event.inc;
+      }
+  }
+  ++event.inc;
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::update()
+{
+  advanceTicks(1);
+  for (uint8_t event_index = 0; event_index < EVENT_COUNT_MAX; ++event_index)
+  {
+    if (eventDue(event_index))
+    {
+      process(event_index,true);
+    }
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+bool EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::eventDue(uint8_t event_index)
+{
+  const Event & event = event_array_[event_index];
+  return (!event.free) && (!event.batched) && (!event.armed) && owns(event_index) && timeReached(event.time);
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::advanceTicks(uint32_t tick_count)
+{
+  noInterrupts();
+  uint32_t ticks_previous = ticks_;
+  int32_t slew_remaining = slew_remaining_;
+  if ((slew_remaining != 0) && (tick_count > 0))
+  {
+    uint32_t slew_magnitude = (slew_remaining > 0) ? (uint32_t)slew_remaining : ((uint32_t)0 - (uint32_t)slew_remaining);
+    uint32_t slew_first = (slew_count_ < slew_period_) ? (uint32_t)(slew_period_ - slew_count_) : 1;
+    uint32_t slew_steps = 0;
+    if (tick_count >= slew_first)
+    {
+      slew_steps = 1 + (tick_count - slew_first) / slew_period_;
+    }
+    if (slew_steps >= slew_magnitude)
+    {
+      slew_steps = slew_magnitude;
+      slew_count_ = 0;
+    }
+    else if (slew_steps > 0)
+    {
+      slew_count_ = tick_count - slew_first - (slew_steps - 1) * slew_period_;
+    }
+    else
+    {
+      slew_count_ = slew_count_ + tick_count;
+    }
+    if (slew_remaining > 0)
+    {
+      ticks_ = ticks_ + slew_steps;
+      slew_remaining_ = slew_remaining - (int32_t)slew_steps;
+    }
+    else
+    {
+      tick_count -= slew_steps;
+      slew_remaining_ = slew_remaining + (int32_t)slew_steps;
+    }
+  }
+  ticks_ = ticks_ + tick_count;
+  if (ticks_ < ticks_previous)
+  {
+    ticks_epoch_ = ticks_epoch_ + 1;
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::advancePeriod(Event & event)
+{
+  event.time += event.period;
+  if (event.phase >= (event.period_denominator - event.period_remainder))
+  {
+    event.phase -= (event.period_denominator - event.period_remainder);
+    ++event.time;
+  }
+  else
+  {
+    event.phase += event.period_remainder;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX, uint16_t TICK_PERIOD_US, bool EVENT_POOL_SHARED, typename EVENT_TIMER>
+void EventController<EVENT_COUNT_MAX,TICK_PERIOD_US,EVENT_POOL_SHARED,EVENT_TIMER>::process(uint8_t event_index,
+  bool catch_up)
+{
+  Event& event = event_array_[event_index];
+  if ((event.enabled) && ((event.infinite) || (event.inc < event.count)))
+  {
+    if ((event.period > 0) || (event.period_remainder > 0))
+    {
+      do
+      {
+        advancePeriod(event);
+      } while (catch_up && timeReached(event.time));
+    }
+    if (event.rearm)
+    {
+      event.armed = true;
+    }
+    dispatch(event);
+    uint8_t batch_index = event.batch_next;
+    while ((batch_index < EVENT_COUNT_MAX) && event_array_[batch_index].batched)
+    {
+      uint8_t batch_index_current = batch_index;
+      Event & batch_event = event_array_[batch_index];
+      batch_index = batch_event.batch_next;
+      batch_event.time = event.time;
+      batch_event.phase = event.phase;
+      if (batch_event.enabled)
+      {
+        dispatch(batch_event);
       }
       else
       {
-        remove(event_index);
+        remove(batch_index_current);
       }
     }
   }
+  else if (event.enabled)
+  {
+    removeBatch(event_index);
+  }
+  else
+  {
+    remove(event_index);
+  }
 }
 
 #endif
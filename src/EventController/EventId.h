@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// EventId.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_ID_H
+#define EVENT_ID_H
+#include <Arduino.h>
+
+
+struct EventId
+{
+  uint8_t index;
+  uint32_t time_start;
+  EventId() :
+  index(255),
+  time_start(0) {}
+};
+struct EventIdPair
+{
+  EventId event_id_0;
+  EventId event_id_1;
+  EventIdPair() :
+  event_id_0(EventId()),
+  event_id_1(EventId()) {}
+};
+
+bool operator==(const EventId& lhs,
+  const EventId& rhs);
+bool operator==(const EventIdPair& lhs,
+  const EventIdPair& rhs);
+bool operator!=(const EventId& lhs,
+  const EventId& rhs);
+bool operator!=(const EventIdPair& lhs,
+  const EventIdPair& rhs);
+
+#endif
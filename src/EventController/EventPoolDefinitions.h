@@ -0,0 +1,222 @@
+// ----------------------------------------------------------------------------
+// EventPoolDefinitions.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_POOL_DEFINITIONS_H
+#define EVENT_POOL_DEFINITIONS_H
+
+
+template <uint8_t EVENT_COUNT_MAX>
+EventPool<EVENT_COUNT_MAX>::EventPool()
+{
+  event_array_.fill(Event());
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    Event & event = event_array_[event_index];
+    event.free = true;
+    event.enabled = false;
+    event.period_denominator = 1;
+    event.arg = -1;
+    event.groups = 0;
+    event.batched = false;
+    event.batch_next = EVENT_INDEX_NONE;
+    event.armed = false;
+    event.handler = HANDLER_NONE;
+    owners_[event_index] = OWNER_NONE;
+    free_next_[event_index] = event_index + 1;
+  }
+  free_head_ = 0;
+  count_ = 0;
+  high_watermark_ = 0;
+  owner_count_ = 0;
+  for (uint8_t owner=0; owner<OWNER_COUNT_MAX; ++owner)
+  {
+    quotas_[owner] = EVENT_COUNT_MAX;
+    counts_[owner] = 0;
+    high_watermarks_[owner] = 0;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::addOwner()
+{
+  if (owner_count_ >= OWNER_COUNT_MAX)
+  {
+    return OWNER_NONE;
+  }
+  return owner_count_++;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+void EventPool<EVENT_COUNT_MAX>::setQuota(uint8_t owner,
+  uint8_t quota)
+{
+  if (owner < owner_count_)
+  {
+    quotas_[owner] = quota;
+  }
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::getQuota(uint8_t owner)
+{
+  if (owner < owner_count_)
+  {
+    return quotas_[owner];
+  }
+  return 0;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::getCount(uint8_t owner)
+{
+  if (owner < owner_count_)
+  {
+    return counts_[owner];
+  }
+  return 0;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::getCount()
+{
+  return count_;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::getAvailable(uint8_t owner)
+{
+  if ((owner >= owner_count_) || (counts_[owner] >= quotas_[owner]))
+  {
+    return 0;
+  }
+  uint8_t available = quotas_[owner] - counts_[owner];
+  if (available > (EVENT_COUNT_MAX - count_))
+  {
+    available = EVENT_COUNT_MAX - count_;
+  }
+  return available;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::getHighWatermark(uint8_t owner)
+{
+  if (owner < owner_count_)
+  {
+    return high_watermarks_[owner];
+  }
+  return 0;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::getHighWatermark()
+{
+  return high_watermark_;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+void EventPool<EVENT_COUNT_MAX>::resetHighWatermarks()
+{
+  noInterrupts();
+  high_watermark_ = count_;
+  for (uint8_t owner=0; owner<owner_count_; ++owner)
+  {
+    high_watermarks_[owner] = counts_[owner];
+  }
+  interrupts();
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+uint8_t EventPool<EVENT_COUNT_MAX>::allocate(uint8_t owner)
+{
+  if ((owner >= owner_count_) ||
+    (counts_[owner] >= quotas_[owner]) ||
+    (free_head_ >= EVENT_COUNT_MAX))
+  {
+    return EVENT_COUNT_MAX;
+  }
+  uint8_t event_index = free_head_;
+  free_head_ = free_next_[event_index];
+  owners_[event_index] = owner;
+  if (++counts_[owner] > high_watermarks_[owner])
+  {
+    high_watermarks_[owner] = counts_[owner];
+  }
+  if (++count_ > high_watermark_)
+  {
+    high_watermark_ = count_;
+  }
+  return event_index;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+bool EventPool<EVENT_COUNT_MAX>::claim(uint8_t event_index,
+  uint8_t owner)
+{
+  if ((event_index >= EVENT_COUNT_MAX) ||
+    (owner >= owner_count_) ||
+    (owners_[event_index] != OWNER_NONE) ||
+    (counts_[owner] >= quotas_[owner]))
+  {
+    return false;
+  }
+  if (free_head_ == event_index)
+  {
+    free_head_ = free_next_[event_index];
+  }
+  else
+  {
+    uint8_t free_index = free_head_;
+    while ((free_index < EVENT_COUNT_MAX) && (free_next_[free_index] != event_index))
+    {
+      free_index = free_next_[free_index];
+    }
+    if (free_index >= EVENT_COUNT_MAX)
+    {
+      return false;
+    }
+    free_next_[free_index] = free_next_[event_index];
+  }
+  owners_[event_index] = owner;
+  if (++counts_[owner] > high_watermarks_[owner])
+  {
+    high_watermarks_[owner] = counts_[owner];
+  }
+  if (++count_ > high_watermark_)
+  {
+    high_watermark_ = count_;
+  }
+  return true;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+void EventPool<EVENT_COUNT_MAX>::deallocate(uint8_t event_index)
+{
+  if ((event_index >= EVENT_COUNT_MAX) || (owners_[event_index] == OWNER_NONE))
+  {
+    return;
+  }
+  --counts_[owners_[event_index]];
+  --count_;
+  owners_[event_index] = OWNER_NONE;
+  free_next_[event_index] = free_head_;
+  free_head_ = event_index;
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+bool EventPool<EVENT_COUNT_MAX>::owns(uint8_t owner,
+  uint8_t event_index)
+{
+  return (event_index < EVENT_COUNT_MAX) && (owners_[event_index] == owner) && (owner != OWNER_NONE);
+}
+
+template <uint8_t EVENT_COUNT_MAX>
+Array<Event,EVENT_COUNT_MAX> & EventPool<EVENT_COUNT_MAX>::getEventArray()
+{
+  return event_array_;
+}
+
+#endif
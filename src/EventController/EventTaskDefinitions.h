@@ -0,0 +1,181 @@
+// ----------------------------------------------------------------------------
+// EventTaskDefinitions.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TASK_DEFINITIONS_H
+#define EVENT_TASK_DEFINITIONS_H
+
+
+inline void * EventTaskPool::allocate(size_t size)
+{
+  if (size > sizeof(Frame))
+  {
+    return nullptr;
+  }
+  void * frame = nullptr;
+  noInterrupts();
+  for (size_t frame_index=0; frame_index<EVENT_TASK_COUNT_MAX; ++frame_index)
+  {
+    if (!frames_used_[frame_index])
+    {
+      frames_used_[frame_index] = true;
+      frame = &frames_[frame_index];
+      break;
+    }
+  }
+  interrupts();
+  return frame;
+}
+
+inline void EventTaskPool::deallocate(void * frame)
+{
+  for (size_t frame_index=0; frame_index<EVENT_TASK_COUNT_MAX; ++frame_index)
+  {
+    if (frame == &frames_[frame_index])
+    {
+      frames_used_[frame_index] = false;
+      break;
+    }
+  }
+}
+
+inline EventTaskStart::EventTaskStart(bool ready) :
+ready_(ready)
+{
+}
+
+inline bool EventTaskStart::await_ready() noexcept
+{
+  return ready_;
+}
+
+inline void EventTaskStart::await_suspend(std::coroutine_handle<EventTaskPromise> handle) noexcept
+{
+  handle.destroy();
+}
+
+inline void EventTaskStart::await_resume() noexcept
+{
+}
+
+template <typename ... Args>
+EventTaskPromise::EventTaskPromise(Args & ... args) :
+event_index(-1),
+running(true)
+{
+  (bind(args), ...);
+}
+
+inline EventTaskPromise::~EventTaskPromise()
+{
+  if (functor_release)
+  {
+    functor_release(event_index);
+  }
+}
+
+inline void * EventTaskPromise::operator new(size_t size) noexcept
+{
+  return EventTaskPool::allocate(size);
+}
+
+inline void EventTaskPromise::operator delete(void * frame)
+{
+  EventTaskPool::deallocate(frame);
+}
+
+inline EventTask EventTaskPromise::get_return_object_on_allocation_failure()
+{
+  return EventTask(false);
+}
+
+inline EventTask EventTaskPromise::get_return_object()
+{
+  return EventTask(event_index >= 0);
+}
+
+inline EventTaskStart EventTaskPromise::initial_suspend() noexcept
+{
+  return EventTaskStart(event_index >= 0);
+}
+
+inline std::suspend_never EventTaskPromise::final_suspend() noexcept
+{
+  return std::suspend_never();
+}
+
+inline void EventTaskPromise::return_void()
+{
+}
+
+inline void EventTaskPromise::unhandled_exception()
+{
+}
+
+inline void EventTaskPromise::resume(int)
+{
+  std::coroutine_handle<EventTaskPromise>::from_promise(*this).resume();
+}
+
+inline void EventTaskPromise::destroy(int)
+{
+  std::coroutine_handle<EventTaskPromise>::from_promise(*this).destroy();
+}
+
+template <typename Arg>
+void EventTaskPromise::bind(Arg &)
+{
+}
+
+template <EventTaskController Controller>
+void EventTaskPromise::bind(Controller & controller)
+{
+  if (event_index < 0)
+  {
+    controller.allocateTask(*this);
+  }
+}
+
+inline EventTask::EventTask(bool valid) :
+valid_(valid)
+{
+}
+
+inline bool EventTask::valid()
+{
+  return valid_;
+}
+
+template <typename Controller>
+EventTaskAwaiter<Controller>::EventTaskAwaiter(Controller & controller,
+  uint32_t time) :
+controller_(controller),
+time_(time)
+{
+}
+
+template <typename Controller>
+bool EventTaskAwaiter<Controller>::await_ready()
+{
+  return false;
+}
+
+template <typename Controller>
+bool EventTaskAwaiter<Controller>::await_suspend(std::coroutine_handle<EventTaskPromise> handle)
+{
+  if (!controller_.scheduleTask(handle.promise(),time_))
+  {
+    handle.destroy();
+  }
+  return true;
+}
+
+template <typename Controller>
+void EventTaskAwaiter<Controller>::await_resume()
+{
+}
+
+#endif
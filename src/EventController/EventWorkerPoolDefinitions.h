@@ -0,0 +1,308 @@
+// ----------------------------------------------------------------------------
+// EventWorkerPoolDefinitions.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_WORKER_POOL_DEFINITIONS_H
+#define EVENT_WORKER_POOL_DEFINITIONS_H
+
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::EventWorkerPool()
+{
+  worker_count_ = 0;
+  worker_next_ = 0;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    constraints_[event_index].serial = false;
+    constraints_[event_index].affinity = WORKER_NONE;
+  }
+  for (uint8_t worker_index=0; worker_index<WORKER_COUNT_MAX; ++worker_index)
+  {
+    workers_[worker_index].executed_count = 0;
+  }
+  running_ = false;
+  generation_ = 0;
+  pending_count_ = 0;
+  steal_count_ = 0;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::~EventWorkerPool()
+{
+  stop();
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+bool EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::start(uint8_t worker_count)
+{
+  if (running_ || (worker_count == 0))
+  {
+    return false;
+  }
+  if (worker_count > WORKER_COUNT_MAX)
+  {
+    worker_count = WORKER_COUNT_MAX;
+  }
+  worker_count_ = worker_count;
+  worker_next_ = 0;
+  steal_count_ = 0;
+  running_ = true;
+  for (uint8_t worker_index=0; worker_index<worker_count_; ++worker_index)
+  {
+    workers_[worker_index].executed_count = 0;
+    workers_[worker_index].thread = std::thread(&EventWorkerPool::run,this,worker_index);
+  }
+  return true;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::stop()
+{
+  if (!running_)
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+    running_ = false;
+  }
+  work_available_.notify_all();
+  for (uint8_t worker_index=0; worker_index<worker_count_; ++worker_index)
+  {
+    workers_[worker_index].thread.join();
+  }
+  worker_count_ = 0;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+uint8_t EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::getWorkerCount()
+{
+  return worker_count_;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::setSerial(const EventId event_id,
+  bool serial)
+{
+  if (event_id.index < EVENT_COUNT_MAX)
+  {
+    std::lock_guard<std::mutex> constraint_lock(constraint_mutex_);
+    claimConstraint(event_id).serial = serial;
+  }
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::setSerial(const EventIdPair event_id_pair,
+  bool serial)
+{
+  setSerial(event_id_pair.event_id_0,serial);
+  setSerial(event_id_pair.event_id_1,serial);
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::setAffinity(const EventId event_id,
+  uint8_t worker_index)
+{
+  if (event_id.index < EVENT_COUNT_MAX)
+  {
+    std::lock_guard<std::mutex> constraint_lock(constraint_mutex_);
+    claimConstraint(event_id).affinity = worker_index;
+  }
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::setAffinity(const EventIdPair event_id_pair,
+  uint8_t worker_index)
+{
+  setAffinity(event_id_pair.event_id_0,worker_index);
+  setAffinity(event_id_pair.event_id_1,worker_index);
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+bool EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::getSerial(const EventId event_id)
+{
+  if (event_id.index >= EVENT_COUNT_MAX)
+  {
+    return false;
+  }
+  std::lock_guard<std::mutex> constraint_lock(constraint_mutex_);
+  const Constraint & constraint = constraints_[event_id.index];
+  return (constraint.event_id == event_id) && constraint.serial;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+uint8_t EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::getAffinity(const EventId event_id)
+{
+  if (event_id.index >= EVENT_COUNT_MAX)
+  {
+    return WORKER_NONE;
+  }
+  std::lock_guard<std::mutex> constraint_lock(constraint_mutex_);
+  const Constraint & constraint = constraints_[event_id.index];
+  if (constraint.event_id != event_id)
+  {
+    return WORKER_NONE;
+  }
+  return constraint.affinity;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::post(const Functor1<int> & functor,
+  int arg,
+  const EventId event_id)
+{
+  if (!running_ || (worker_count_ == 0))
+  {
+    functor(arg);
+    return;
+  }
+  EventWorkerTask task;
+  task.functor = functor;
+  task.arg = arg;
+  task.event_id = event_id;
+  task.serial = getSerial(event_id);
+  uint8_t affinity = getAffinity(event_id);
+  uint8_t worker_index;
+  if (affinity < worker_count_)
+  {
+    worker_index = affinity;
+  }
+  else if (task.serial)
+  {
+    worker_index = event_id.index % worker_count_;
+  }
+  else
+  {
+    worker_index = worker_next_;
+    worker_next_ = (worker_next_ + 1) % worker_count_;
+  }
+  ++pending_count_;
+  {
+    std::lock_guard<std::mutex> worker_lock(workers_[worker_index].mutex);
+    workers_[worker_index].tasks.push_back(task);
+  }
+  {
+    std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+    ++generation_;
+  }
+  work_available_.notify_all();
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::wait()
+{
+  std::unique_lock<std::mutex> idle_lock(idle_mutex_);
+  while (pending_count_ > 0)
+  {
+    work_done_.wait(idle_lock);
+  }
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+uint32_t EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::getExecutedCount(uint8_t worker_index)
+{
+  if (worker_index < WORKER_COUNT_MAX)
+  {
+    return workers_[worker_index].executed_count;
+  }
+  return 0;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+uint32_t EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::getStealCount()
+{
+  return steal_count_;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+typename EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::Constraint & EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::claimConstraint(const EventId event_id)
+{
+  Constraint & constraint = constraints_[event_id.index];
+  if (constraint.event_id != event_id)
+  {
+    constraint.event_id = event_id;
+    constraint.serial = false;
+    constraint.affinity = WORKER_NONE;
+  }
+  return constraint;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::run(uint8_t worker_index)
+{
+  while (true)
+  {
+    uint32_t generation = generation_;
+    EventWorkerTask task;
+    if (popTask(worker_index,task) || stealTask(worker_index,task))
+    {
+      task.functor(task.arg);
+      ++workers_[worker_index].executed_count;
+      finishTask();
+      continue;
+    }
+    std::unique_lock<std::mutex> idle_lock(idle_mutex_);
+    if (!running_)
+    {
+      return;
+    }
+    while (running_ && (generation == generation_))
+    {
+      work_available_.wait(idle_lock);
+    }
+  }
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+bool EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::popTask(uint8_t worker_index,
+  EventWorkerTask & task)
+{
+  Worker & worker = workers_[worker_index];
+  std::lock_guard<std::mutex> worker_lock(worker.mutex);
+  if (worker.tasks.empty())
+  {
+    return false;
+  }
+  task = worker.tasks.front();
+  worker.tasks.pop_front();
+  return true;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+bool EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::stealTask(uint8_t worker_index,
+  EventWorkerTask & task)
+{
+  for (uint8_t victim_offset=1; victim_offset<worker_count_; ++victim_offset)
+  {
+    Worker & victim = workers_[(worker_index + victim_offset) % worker_count_];
+    std::lock_guard<std::mutex> victim_lock(victim.mutex);
+    for (typename std::deque<EventWorkerTask>::reverse_iterator task_iterator=victim.tasks.rbegin();
+      task_iterator!=victim.tasks.rend();
+      ++task_iterator)
+    {
+      if (!task_iterator->serial)
+      {
+        task = *task_iterator;
+        victim.tasks.erase(--task_iterator.base());
+        ++steal_count_;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+void EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX>::finishTask()
+{
+  if (--pending_count_ == 0)
+  {
+    std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+    work_done_.notify_all();
+  }
+}
+
+#endif
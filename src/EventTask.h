@@ -0,0 +1,110 @@
+// ----------------------------------------------------------------------------
+// EventTask.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TASK_H
+#define EVENT_TASK_H
+#include <Arduino.h>
+#include <coroutine>
+#include <Functor.h>
+
+
+#ifndef EVENT_TASK_COUNT_MAX
+#define EVENT_TASK_COUNT_MAX 4
+#endif
+
+#ifndef EVENT_TASK_FRAME_SIZE_MAX
+#define EVENT_TASK_FRAME_SIZE_MAX 128
+#endif
+
+class EventTaskPool
+{
+public:
+  static void * allocate(size_t size);
+  static void deallocate(void * frame);
+private:
+  struct alignas(alignof(max_align_t)) Frame
+  {
+    unsigned char bytes[EVENT_TASK_FRAME_SIZE_MAX];
+  };
+  static inline Frame frames_[EVENT_TASK_COUNT_MAX];
+  static inline bool frames_used_[EVENT_TASK_COUNT_MAX];
+};
+
+class EventTask;
+class EventTaskPromise;
+
+template <typename Controller>
+concept EventTaskController = requires (Controller & controller)
+{
+  controller.delay(0);
+};
+
+class EventTaskStart
+{
+public:
+  EventTaskStart(bool ready);
+  bool await_ready() noexcept;
+  void await_suspend(std::coroutine_handle<EventTaskPromise> handle) noexcept;
+  void await_resume() noexcept;
+private:
+  bool ready_;
+};
+
+class EventTaskPromise
+{
+public:
+  template <typename ... Args>
+  EventTaskPromise(Args & ... args);
+  ~EventTaskPromise();
+  static void * operator new(size_t size) noexcept;
+  static void operator delete(void * frame);
+  static EventTask get_return_object_on_allocation_failure();
+  EventTask get_return_object();
+  EventTaskStart initial_suspend() noexcept;
+  std::suspend_never final_suspend() noexcept;
+  void return_void();
+  void unhandled_exception();
+  void resume(int arg=-1);
+  void destroy(int arg=-1);
+
+  int event_index;
+  bool running;
+  Functor1<int> functor_release;
+private:
+  template <typename Arg>
+  void bind(Arg &);
+  template <EventTaskController Controller>
+  void bind(Controller & controller);
+};
+
+class EventTask
+{
+public:
+  typedef EventTaskPromise promise_type;
+  EventTask(bool valid=true);
+  bool valid();
+private:
+  bool valid_;
+};
+
+template <typename Controller>
+class EventTaskAwaiter
+{
+public:
+  EventTaskAwaiter(Controller & controller,
+    uint32_t time);
+  bool await_ready();
+  bool await_suspend(std::coroutine_handle<EventTaskPromise> handle);
+  void await_resume();
+private:
+  Controller & controller_;
+  uint32_t time_;
+};
+
+#include "EventController/EventTaskDefinitions.h"
+
+#endif
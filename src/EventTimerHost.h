@@ -0,0 +1,38 @@
+// ----------------------------------------------------------------------------
+// EventTimerHost.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_HOST_H
+#define EVENT_TIMER_HOST_H
+#include <Arduino.h>
+
+
+struct EventTimerHost
+{
+  typedef void (*Isr)();
+  template <typename Controller>
+  static void start(Controller &,
+    size_t,
+    uint32_t)
+  {
+    isr() = Controller::isr;
+  }
+  static void tick(uint32_t tick_count=1)
+  {
+    Isr tick_isr = isr();
+    while (tick_isr && (tick_count-- > 0))
+    {
+      tick_isr();
+    }
+  }
+  static Isr & isr()
+  {
+    static Isr isr_ = 0;
+    return isr_;
+  }
+};
+
+#endif
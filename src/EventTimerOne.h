@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// EventTimerOne.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_ONE_H
+#define EVENT_TIMER_ONE_H
+#include <Arduino.h>
+#include <TimerOne.h>
+
+
+struct EventTimerOne
+{
+  template <typename Controller>
+  static void start(Controller &,
+    size_t,
+    uint32_t period_us)
+  {
+    Timer1.initialize(period_us);
+    Timer1.attachInterrupt(Controller::isr);
+  }
+};
+
+#endif
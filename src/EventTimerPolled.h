@@ -0,0 +1,23 @@
+// ----------------------------------------------------------------------------
+// EventTimerPolled.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_POLLED_H
+#define EVENT_TIMER_POLLED_H
+#include <Arduino.h>
+
+
+struct EventTimerPolled
+{
+  template <typename Controller>
+  static void start(Controller &,
+    size_t,
+    uint32_t)
+  {
+  }
+};
+
+#endif
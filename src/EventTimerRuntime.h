@@ -0,0 +1,47 @@
+// ----------------------------------------------------------------------------
+// EventTimerRuntime.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_RUNTIME_H
+#define EVENT_TIMER_RUNTIME_H
+#include <Arduino.h>
+#include <TimerOne.h>
+#include <TimerThree.h>
+#include <Functor.h>
+#include <FunctorCallbacks.h>
+
+
+struct EventTimerRuntime
+{
+  template <typename Controller>
+  static void start(Controller & controller,
+    size_t timer_number,
+    uint32_t period_us)
+  {
+    if (timer_number == 3)
+    {
+      Timer3.initialize(period_us);
+    }
+    else
+    {
+      Timer1.initialize(period_us);
+    }
+    FunctorCallbacks::Callback callback = FunctorCallbacks::add(makeFunctor((Functor0 *)0,controller,&Controller::update));
+    if (callback)
+    {
+      if (timer_number == 3)
+      {
+        Timer3.attachInterrupt(callback);
+      }
+      else
+      {
+        Timer1.attachInterrupt(callback);
+      }
+    }
+  }
+};
+
+#endif
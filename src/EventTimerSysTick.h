@@ -0,0 +1,53 @@
+// ----------------------------------------------------------------------------
+// EventTimerSysTick.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_SYS_TICK_H
+#define EVENT_TIMER_SYS_TICK_H
+#include <Arduino.h>
+
+#if defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_SAM)
+
+struct EventTimerSysTick
+{
+  typedef void (*Isr)();
+  template <typename Controller>
+  static void start(Controller &,
+    size_t,
+    uint32_t)
+  {
+    static_assert(Controller::TICKS_PER_MILLI_SEC == 1,
+      "EventTimerSysTick requires a one millisecond tick period");
+    noInterrupts();
+    isr() = Controller::isr;
+    interrupts();
+  }
+  static void tick()
+  {
+    Isr tick_isr = isr();
+    if (tick_isr)
+    {
+      tick_isr();
+    }
+  }
+  static Isr volatile & isr()
+  {
+    static Isr volatile isr_ = 0;
+    return isr_;
+  }
+};
+
+#if defined(EVENT_TIMER_SYS_TICK_HOOK)
+extern "C" int sysTickHook(void)
+{
+  EventTimerSysTick::tick();
+  return 0;
+}
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+// ----------------------------------------------------------------------------
+// EventTimerThree.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_THREE_H
+#define EVENT_TIMER_THREE_H
+#include <Arduino.h>
+#include <TimerThree.h>
+
+
+struct EventTimerThree
+{
+  template <typename Controller>
+  static void start(Controller &,
+    size_t,
+    uint32_t period_us)
+  {
+    Timer3.initialize(period_us);
+    Timer3.attachInterrupt(Controller::isr);
+  }
+};
+
+#endif
@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+// EventWorkerPool.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_WORKER_POOL_H
+#define EVENT_WORKER_POOL_H
+#include <Arduino.h>
+#include <Functor.h>
+#include "EventController/EventId.h"
+
+#if defined(__linux__)
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+
+struct EventWorkerTask
+{
+  Functor1<int> functor;
+  int arg;
+  EventId event_id;
+  bool serial;
+};
+
+template <uint8_t WORKER_COUNT_MAX, uint8_t EVENT_COUNT_MAX>
+class EventWorkerPool
+{
+public:
+  EventWorkerPool();
+  ~EventWorkerPool();
+  enum{WORKER_NONE=255};
+
+  bool start(uint8_t worker_count);
+  void stop();
+  uint8_t getWorkerCount();
+
+  void setSerial(const EventId event_id,
+    bool serial=true);
+  void setSerial(const EventIdPair event_id_pair,
+    bool serial=true);
+  void setAffinity(const EventId event_id,
+    uint8_t worker_index);
+  void setAffinity(const EventIdPair event_id_pair,
+    uint8_t worker_index);
+  bool getSerial(const EventId event_id);
+  uint8_t getAffinity(const EventId event_id);
+
+  void post(const Functor1<int> & functor,
+    int arg,
+    const EventId event_id);
+  void wait();
+
+  uint32_t getExecutedCount(uint8_t worker_index);
+  uint32_t getStealCount();
+
+private:
+  struct Worker
+  {
+    std::mutex mutex;
+    std::deque<EventWorkerTask> tasks;
+    std::thread thread;
+    std::atomic<uint32_t> executed_count;
+  };
+  struct Constraint
+  {
+    EventId event_id;
+    bool serial;
+    uint8_t affinity;
+  };
+  Worker workers_[WORKER_COUNT_MAX];
+  uint8_t worker_count_;
+  uint8_t worker_next_;
+  Constraint constraints_[EVENT_COUNT_MAX];
+  std::mutex constraint_mutex_;
+  std::atomic<bool> running_;
+  std::atomic<uint32_t> generation_;
+  std::atomic<uint32_t> pending_count_;
+  std::atomic<uint32_t> steal_count_;
+  std::mutex idle_mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+
+  Constraint & claimConstraint(const EventId event_id);
+  void run(uint8_t worker_index);
+  bool popTask(uint8_t worker_index,
+    EventWorkerTask & task);
+  bool stealTask(uint8_t worker_index,
+    EventWorkerTask & task);
+  void finishTask();
+};
+
+#include "EventController/EventWorkerPoolDefinitions.h"
+
+#endif
+
+#endif
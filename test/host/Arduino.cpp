@@ -0,0 +1,203 @@
+// ----------------------------------------------------------------------------
+// Arduino.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#include "Arduino.h"
+#include <signal.h>
+#include <mutex>
+
+
+HostPort host_ports[HOST_PORT_COUNT];
+volatile uint32_t host_micros = 0;
+
+static void (* volatile host_interrupt_handler)() = 0;
+static std::recursive_mutex host_interrupt_mutex;
+static thread_local volatile sig_atomic_t host_interrupt_depth = 0;
+static thread_local volatile sig_atomic_t host_interrupt_active = 0;
+static volatile sig_atomic_t host_interrupt_pending = 0;
+static void (* volatile host_pin_handlers[HOST_PIN_COUNT])();
+static volatile uint8_t host_pin_modes[HOST_PIN_COUNT];
+static volatile bool host_pin_pending[HOST_PIN_COUNT];
+
+static void hostRunPinInterrupts()
+{
+  for (uint8_t pin=0; pin<HOST_PIN_COUNT; ++pin)
+  {
+    void (*handler)() = host_pin_handlers[pin];
+    if (host_pin_pending[pin] && handler)
+    {
+      host_pin_pending[pin] = false;
+      host_interrupt_active = 1;
+      __asm__ __volatile__ ("" ::: "memory");
+      handler();
+      __asm__ __volatile__ ("" ::: "memory");
+      host_interrupt_active = 0;
+    }
+  }
+}
+
+void noInterrupts()
+{
+  if (host_interrupt_active)
+  {
+    return;
+  }
+  host_interrupt_mutex.lock();
+  host_interrupt_depth = host_interrupt_depth + 1;
+  __asm__ __volatile__ ("" ::: "memory");
+}
+
+void interrupts()
+{
+  if (host_interrupt_active || (host_interrupt_depth == 0))
+  {
+    return;
+  }
+  __asm__ __volatile__ ("" ::: "memory");
+  host_interrupt_depth = host_interrupt_depth - 1;
+  host_interrupt_mutex.unlock();
+  if (host_interrupt_depth == 0)
+  {
+    hostRunPinInterrupts();
+    if (host_interrupt_pending)
+    {
+      hostRaiseInterrupt();
+    }
+  }
+}
+
+void hostAttachInterrupt(void (*handler)())
+{
+  host_interrupt_handler = handler;
+}
+
+void hostRaiseInterrupt()
+{
+  if ((host_interrupt_depth > 0) || host_interrupt_active || !host_interrupt_handler)
+  {
+    host_interrupt_pending = 1;
+    return;
+  }
+  host_interrupt_active = 1;
+  host_interrupt_pending = 0;
+  __asm__ __volatile__ ("" ::: "memory");
+  host_interrupt_handler();
+  __asm__ __volatile__ ("" ::: "memory");
+  host_interrupt_active = 0;
+}
+
+uint32_t micros()
+{
+  return host_micros;
+}
+
+uint32_t millis()
+{
+  return host_micros / 1000;
+}
+
+void pinMode(uint8_t,
+  uint8_t)
+{
+}
+
+void digitalWrite(uint8_t pin,
+  uint8_t value)
+{
+  volatile uint32_t * port_register = portOutputRegister(digitalPinToPort(pin));
+  if (port_register == 0)
+  {
+    return;
+  }
+  if (value == LOW)
+  {
+    *port_register = *port_register & ~digitalPinToBitMask(pin);
+  }
+  else
+  {
+    *port_register = *port_register | digitalPinToBitMask(pin);
+  }
+}
+
+int digitalRead(uint8_t pin)
+{
+  volatile uint32_t * port_register = portOutputRegister(digitalPinToPort(pin));
+  if ((port_register == 0) || !(*port_register & digitalPinToBitMask(pin)))
+  {
+    return LOW;
+  }
+  return HIGH;
+}
+
+void attachInterrupt(uint8_t interrupt,
+  void (*handler)(),
+  int mode)
+{
+  if (interrupt < HOST_PIN_COUNT)
+  {
+    host_pin_pending[interrupt] = false;
+    host_pin_modes[interrupt] = mode;
+    host_pin_handlers[interrupt] = handler;
+  }
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+  if (interrupt < HOST_PIN_COUNT)
+  {
+    host_pin_handlers[interrupt] = 0;
+    host_pin_pending[interrupt] = false;
+  }
+}
+
+void hostDriveInput(uint8_t pin,
+  uint8_t value)
+{
+  if (pin >= HOST_PIN_COUNT)
+  {
+    return;
+  }
+  int value_previous = digitalRead(pin);
+  digitalWrite(pin,value);
+  int value_current = digitalRead(pin);
+  if ((value_current == value_previous) || !host_pin_handlers[pin])
+  {
+    return;
+  }
+  uint8_t mode = host_pin_modes[pin];
+  if ((mode == CHANGE) ||
+    ((mode == RISING) && (value_current == HIGH)) ||
+    ((mode == FALLING) && (value_current == LOW)))
+  {
+    host_pin_pending[pin] = true;
+    if ((host_interrupt_depth == 0) && !host_interrupt_active)
+    {
+      hostRunPinInterrupts();
+    }
+  }
+}
+
+size_t Stream::write(const uint8_t * buffer,
+  size_t size)
+{
+  size_t written = 0;
+  while (size-- > 0)
+  {
+    written += write(*buffer++);
+  }
+  return written;
+}
+
+size_t Stream::readBytes(uint8_t * buffer,
+  size_t length)
+{
+  size_t count = 0;
+  while ((count < length) && (available() > 0))
+  {
+    buffer[count++] = read();
+  }
+  return count;
+}
@@ -0,0 +1,70 @@
+// ----------------------------------------------------------------------------
+// Arduino.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef ARDUINO_H
+#define ARDUINO_H
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define CHANGE 0x1
+#define FALLING 0x2
+#define RISING 0x3
+#define HOST_PORT_COUNT 4
+#define HOST_PIN_COUNT (HOST_PORT_COUNT * 8)
+
+struct HostPort
+{
+  volatile uint32_t out;
+};
+
+extern HostPort host_ports[HOST_PORT_COUNT];
+extern volatile uint32_t host_micros;
+
+void noInterrupts();
+void interrupts();
+void hostAttachInterrupt(void (*handler)());
+void hostRaiseInterrupt();
+uint32_t micros();
+uint32_t millis();
+void pinMode(uint8_t pin,
+  uint8_t mode);
+void digitalWrite(uint8_t pin,
+  uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt,
+  void (*handler)(),
+  int mode);
+void detachInterrupt(uint8_t interrupt);
+void hostDriveInput(uint8_t pin,
+  uint8_t value);
+
+#define digitalPinToInterrupt(pin) (((pin) < HOST_PIN_COUNT) ? (pin) : 255)
+
+#define digitalPinToPort(pin) (((pin) < HOST_PIN_COUNT) ? &host_ports[(pin) / 8] : (HostPort *)0)
+#define digitalPinToBitMask(pin) ((uint32_t)1 << ((pin) % 8))
+#define portOutputRegister(port) (((port) == 0) ? (volatile uint32_t *)0 : &(port)->out)
+
+class Stream
+{
+public:
+  virtual ~Stream() {}
+  virtual size_t write(uint8_t byte) = 0;
+  virtual size_t write(const uint8_t * buffer,
+    size_t size);
+  virtual int available() = 0;
+  virtual int read() = 0;
+  size_t readBytes(uint8_t * buffer,
+    size_t length);
+};
+
+#endif
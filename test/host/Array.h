@@ -0,0 +1,48 @@
+// ----------------------------------------------------------------------------
+// Array.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef ARRAY_H
+#define ARRAY_H
+#include <stddef.h>
+
+
+template <typename T, size_t MAX_SIZE>
+class Array
+{
+public:
+  Array() :
+  size_(0) {}
+  T & operator[](size_t index)
+  {
+    return values_[index];
+  }
+  const T & operator[](size_t index) const
+  {
+    return values_[index];
+  }
+  void fill(const T & value)
+  {
+    for (size_t index=0; index<MAX_SIZE; ++index)
+    {
+      values_[index] = value;
+    }
+    size_ = MAX_SIZE;
+  }
+  size_t size() const
+  {
+    return size_;
+  }
+  size_t max_size() const
+  {
+    return MAX_SIZE;
+  }
+private:
+  T values_[MAX_SIZE];
+  size_t size_;
+};
+
+#endif
@@ -0,0 +1,64 @@
+// ----------------------------------------------------------------------------
+// BatchTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+enum{BATCH_SIZE=4};
+
+EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> event_controller;
+int dispatch_order[EVENT_COUNT_MAX];
+int dispatch_count = 0;
+
+void orderHandler(int arg)
+{
+  if (dispatch_count < EVENT_COUNT_MAX)
+  {
+    dispatch_order[dispatch_count] = arg;
+  }
+  ++dispatch_count;
+}
+
+int main()
+{
+  Functor1<int> order_functor = makeFunctor((Functor1<int> *)0,orderHandler);
+  event_controller.setup();
+
+  EventId event_ids[BATCH_SIZE];
+  for (int batch_index=0; batch_index<BATCH_SIZE; ++batch_index)
+  {
+    event_ids[batch_index] = event_controller.addRecurringEventUsingDelay(order_functor,5,5,2,batch_index);
+    event_controller.enable(event_ids[batch_index]);
+  }
+  CHECK_EQUAL(BATCH_SIZE - 1,event_controller.coalesceAll());
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(BATCH_SIZE,dispatch_count);
+  for (int batch_index=0; batch_index<BATCH_SIZE; ++batch_index)
+  {
+    CHECK_EQUAL(batch_index,dispatch_order[batch_index]);
+  }
+
+  event_controller.remove(event_ids[0]);
+  dispatch_count = 0;
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(BATCH_SIZE - 1,dispatch_count);
+  for (int batch_index=1; batch_index<BATCH_SIZE; ++batch_index)
+  {
+    CHECK_EQUAL(batch_index,dispatch_order[batch_index - 1]);
+  }
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(BATCH_SIZE - 1,dispatch_count);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  return HOST_TEST_RESULT("BatchTest");
+}
@@ -0,0 +1,311 @@
+// ----------------------------------------------------------------------------
+// CommandTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=4};
+enum{HANDLER_COUNT=2};
+enum{FRAME_SIZE_MAX=128};
+
+typedef EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> CommandController;
+
+CommandController event_controller;
+EventHandler handlers[HANDLER_COUNT];
+uint8_t frame[FRAME_SIZE_MAX];
+uint8_t response[FRAME_SIZE_MAX];
+uint8_t * frame_end;
+int handler_counts[HANDLER_COUNT];
+int handler_arg = 0;
+
+void handler0(int arg)
+{
+  ++handler_counts[0];
+  handler_arg = arg;
+}
+
+void handler1(int arg)
+{
+  ++handler_counts[1];
+  handler_arg = arg;
+}
+
+void putValue(uint32_t value,
+  uint8_t byte_count)
+{
+  for (uint8_t byte_index=0; byte_index<byte_count; ++byte_index)
+  {
+    *frame_end++ = value >> (8 * byte_index);
+  }
+}
+
+uint32_t getValue(const uint8_t * & buffer,
+  uint8_t byte_count)
+{
+  uint32_t value = 0;
+  for (uint8_t byte_index=0; byte_index<byte_count; ++byte_index)
+  {
+    value |= (uint32_t)(*buffer++) << (8 * byte_index);
+  }
+  return value;
+}
+
+void beginFrame()
+{
+  frame_end = frame + CommandController::COMMAND_FRAME_HEADER_SIZE;
+}
+
+size_t endFrame()
+{
+  size_t frame_size = frame_end - frame;
+  uint8_t * header = frame_end;
+  frame_end = frame;
+  putValue(frame_size - CommandController::COMMAND_FRAME_HEADER_SIZE,CommandController::COMMAND_FRAME_HEADER_SIZE);
+  frame_end = header;
+  return frame_size;
+}
+
+void putAdd(uint8_t handler,
+  uint32_t delay,
+  uint32_t period_ms,
+  uint16_t period_denominator,
+  uint16_t count,
+  int32_t arg,
+  bool enabled)
+{
+  putValue(CommandController::COMMAND_ADD,1);
+  putValue(handler,1);
+  putValue(delay,4);
+  putValue(period_ms,4);
+  putValue(period_denominator,2);
+  putValue(count,2);
+  putValue(arg,4);
+  putValue(enabled,1);
+}
+
+void putEventId(uint8_t op,
+  const EventId event_id)
+{
+  putValue(op,1);
+  putValue(event_id.index,1);
+  putValue(event_id.time_start,4);
+}
+
+void putModify(const EventId event_id,
+  uint8_t handler,
+  int32_t arg)
+{
+  putEventId(CommandController::COMMAND_MODIFY,event_id);
+  putValue(handler,1);
+  putValue(arg,4);
+}
+
+size_t process(size_t frame_size,
+  size_t response_size=FRAME_SIZE_MAX)
+{
+  memset(response,0xAA,sizeof(response));
+  return event_controller.processCommands(frame,frame_size,response,response_size);
+}
+
+EventId addEvent(uint8_t handler,
+  uint32_t delay,
+  uint32_t period_ms,
+  uint16_t count,
+  int32_t arg)
+{
+  beginFrame();
+  putAdd(handler,delay,period_ms,1,count,arg,true);
+  size_t response_size = process(endFrame());
+  const uint8_t * result = response;
+  CHECK_EQUAL((size_t)CommandController::COMMAND_FRAME_HEADER_SIZE + CommandController::COMMAND_RESULT_SIZE_MAX,response_size);
+  CHECK_EQUAL(CommandController::COMMAND_RESULT_SIZE_MAX,getValue(result,CommandController::COMMAND_FRAME_HEADER_SIZE));
+  CHECK_EQUAL(CommandController::COMMAND_OK,getValue(result,1));
+  EventId event_id;
+  event_id.index = getValue(result,1);
+  event_id.time_start = getValue(result,4);
+  return event_id;
+}
+
+void checkStatuses(size_t response_size,
+  const uint8_t * statuses,
+  uint8_t status_count)
+{
+  const uint8_t * result = response;
+  CHECK_EQUAL(CommandController::COMMAND_FRAME_HEADER_SIZE + status_count,response_size);
+  CHECK_EQUAL(status_count,getValue(result,CommandController::COMMAND_FRAME_HEADER_SIZE));
+  for (uint8_t status_index=0; status_index<status_count; ++status_index)
+  {
+    CHECK_EQUAL(statuses[status_index],result[status_index]);
+  }
+}
+
+void checkAdd()
+{
+  EventId event_id = addEvent(0,5,10,3,7);
+  CHECK(event_id.index < EVENT_COUNT_MAX);
+  CHECK_EQUAL(event_controller.getTicks(),event_id.time_start);
+  Event event = event_controller.getEvent(event_id);
+  CHECK(event.enabled);
+  CHECK_EQUAL(10,event.period);
+  CHECK_EQUAL(3,event.count);
+  CHECK_EQUAL(7,event.arg);
+  CHECK_EQUAL(0,event.handler);
+
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(1,handler_counts[0]);
+  CHECK_EQUAL(7,handler_arg);
+  EventTimerHost::tick(20);
+  CHECK_EQUAL(3,handler_counts[0]);
+  EventTimerHost::tick(10);
+  CHECK_EQUAL(3,handler_counts[0]);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  EventId infinite_id = addEvent(1,1,1,CommandController::COMMAND_COUNT_INFINITE,-2);
+  CHECK(event_controller.getEvent(infinite_id).infinite);
+  EventTimerHost::tick(4);
+  CHECK_EQUAL(4,handler_counts[1]);
+  CHECK_EQUAL(-2,handler_arg);
+  event_controller.removeAllEvents();
+}
+
+void checkBatch()
+{
+  EventId event_id = addEvent(0,100,0,1,1);
+  beginFrame();
+  putModify(event_id,1,9);
+  putEventId(CommandController::COMMAND_DISABLE,event_id);
+  putEventId(CommandController::COMMAND_ENABLE,event_id);
+  putModify(event_id,CommandController::HANDLER_NONE,11);
+  const uint8_t ok_statuses[] = {CommandController::COMMAND_OK,
+                                 CommandController::COMMAND_OK,
+                                 CommandController::COMMAND_OK,
+                                 CommandController::COMMAND_OK};
+  checkStatuses(process(endFrame()),ok_statuses,4);
+  Event event = event_controller.getEvent(event_id);
+  CHECK_EQUAL(1,event.handler);
+  CHECK_EQUAL(11,event.arg);
+  CHECK(event.enabled);
+
+  beginFrame();
+  putEventId(CommandController::COMMAND_DISABLE,event_id);
+  checkStatuses(process(endFrame()),ok_statuses,1);
+  CHECK(!event_controller.getEvent(event_id).enabled);
+
+  beginFrame();
+  putEventId(CommandController::COMMAND_REMOVE,event_id);
+  putEventId(CommandController::COMMAND_REMOVE,event_id);
+  const uint8_t remove_statuses[] = {CommandController::COMMAND_OK,
+                                     CommandController::COMMAND_INVALID_EVENT};
+  checkStatuses(process(endFrame()),remove_statuses,2);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+}
+
+void checkInvalid()
+{
+  EventId event_id = addEvent(0,100,0,1,1);
+  EventId stale_id = event_id;
+  ++stale_id.time_start;
+  EventId out_of_range_id;
+  out_of_range_id.index = EVENT_COUNT_MAX;
+  out_of_range_id.time_start = event_id.time_start;
+  beginFrame();
+  putEventId(CommandController::COMMAND_ENABLE,stale_id);
+  putEventId(CommandController::COMMAND_REMOVE,out_of_range_id);
+  putModify(out_of_range_id,0,0);
+  putModify(event_id,HANDLER_COUNT,0);
+  putAdd(HANDLER_COUNT,1,1,1,1,0,true);
+  putAdd(0,1,1,0,1,0,true);
+  const uint8_t statuses[] = {CommandController::COMMAND_INVALID_EVENT,
+                              CommandController::COMMAND_INVALID_EVENT,
+                              CommandController::COMMAND_INVALID_EVENT,
+                              CommandController::COMMAND_INVALID_HANDLER,
+                              CommandController::COMMAND_INVALID_HANDLER,
+                              CommandController::COMMAND_INVALID_PERIOD};
+  checkStatuses(process(endFrame()),statuses,6);
+  CHECK_EQUAL(0,event_controller.getEvent(event_id).handler);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+
+  beginFrame();
+  putEventId(CommandController::COMMAND_DISABLE,event_id);
+  putValue(0,1);
+  putEventId(CommandController::COMMAND_REMOVE,event_id);
+  const uint8_t op_statuses[] = {CommandController::COMMAND_OK,
+                                 CommandController::COMMAND_INVALID_OP};
+  checkStatuses(process(endFrame()),op_statuses,2);
+  CHECK(!event_controller.getEvent(event_id).enabled);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+
+  beginFrame();
+  putValue(CommandController::COMMAND_REMOVE + 1,1);
+  const uint8_t invalid_op_status[] = {CommandController::COMMAND_INVALID_OP};
+  checkStatuses(process(endFrame()),invalid_op_status,1);
+
+  for (uint8_t event_index=1; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    addEvent(0,100,0,1,1);
+  }
+  beginFrame();
+  putAdd(0,100,0,1,1,0,true);
+  const uint8_t full_status[] = {CommandController::COMMAND_FULL};
+  checkStatuses(process(endFrame()),full_status,1);
+  event_controller.removeAllEvents();
+}
+
+void checkTruncated()
+{
+  EventId event_id = addEvent(0,100,0,1,1);
+  beginFrame();
+  putEventId(CommandController::COMMAND_DISABLE,event_id);
+  putEventId(CommandController::COMMAND_REMOVE,event_id);
+  size_t frame_size = endFrame();
+  const uint8_t truncated_statuses[] = {CommandController::COMMAND_OK,
+                                        CommandController::COMMAND_TRUNCATED};
+  checkStatuses(process(frame_size - 1),truncated_statuses,2);
+  CHECK(!event_controller.getEvent(event_id).enabled);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+
+  frame[0] = CommandController::COMMAND_EVENT_ID_SIZE + 2;
+  checkStatuses(process(frame_size),truncated_statuses,2);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+
+  beginFrame();
+  putAdd(0,100,0,1,1,0,true);
+  frame_size = endFrame();
+  const uint8_t add_status[] = {CommandController::COMMAND_TRUNCATED};
+  checkStatuses(process(frame_size - 1),add_status,1);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+
+  CHECK_EQUAL(0,process(1));
+  CHECK_EQUAL(0,process(frame_size,1));
+  checkStatuses(process(frame_size,(size_t)CommandController::COMMAND_FRAME_HEADER_SIZE + CommandController::COMMAND_RESULT_SIZE_MAX - 1),0,0);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+
+  beginFrame();
+  checkStatuses(process(endFrame()),0,0);
+  event_controller.removeAllEvents();
+}
+
+int main()
+{
+  handlers[0].functor = makeFunctor((Functor1<int> *)0,handler0);
+  handlers[1].functor = makeFunctor((Functor1<int> *)0,handler1);
+  event_controller.setup();
+  event_controller.setHandlerTable(handlers,HANDLER_COUNT);
+
+  checkAdd();
+  checkBatch();
+  checkInvalid();
+  checkTruncated();
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  return HOST_TEST_RESULT("CommandTest");
+}
@@ -0,0 +1,99 @@
+// ----------------------------------------------------------------------------
+// EventTimerThread.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef EVENT_TIMER_THREAD_H
+#define EVENT_TIMER_THREAD_H
+#include <Arduino.h>
+
+#if defined(__linux__)
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+
+struct EventTimerThread
+{
+  typedef void (*Isr)();
+  enum{NANO_SEC_PER_SEC=1000000000};
+  enum{NANO_SEC_PER_MICRO_SEC=1000};
+  template <typename Controller>
+  static void start(Controller &,
+    size_t,
+    uint32_t period_us)
+  {
+    State & state = getState();
+    __atomic_store_n(&state.isr,&Controller::isr,__ATOMIC_RELEASE);
+    __atomic_store_n(&state.period_ns,period_us * NANO_SEC_PER_MICRO_SEC,__ATOMIC_RELEASE);
+    if (!__atomic_exchange_n(&state.running,true,__ATOMIC_ACQ_REL))
+    {
+      if (pthread_create(&state.thread,0,run,0) != 0)
+      {
+        __atomic_store_n(&state.running,false,__ATOMIC_RELEASE);
+      }
+    }
+  }
+  static void stop()
+  {
+    State & state = getState();
+    if (__atomic_exchange_n(&state.running,false,__ATOMIC_ACQ_REL))
+    {
+      pthread_join(state.thread,0);
+    }
+  }
+  static uint32_t getOverrunCount()
+  {
+    return __atomic_load_n(&getState().overrun_count,__ATOMIC_ACQUIRE);
+  }
+private:
+  struct State
+  {
+    pthread_t thread;
+    Isr isr;
+    uint64_t period_ns;
+    bool running;
+    uint32_t overrun_count;
+  };
+  static State & getState()
+  {
+    static State state = {};
+    return state;
+  }
+  static void * run(void *)
+  {
+    State & state = getState();
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC,&deadline);
+    while (__atomic_load_n(&state.running,__ATOMIC_ACQUIRE))
+    {
+      uint64_t deadline_ns = (uint64_t)deadline.tv_nsec + __atomic_load_n(&state.period_ns,__ATOMIC_ACQUIRE);
+      deadline.tv_sec += deadline_ns / NANO_SEC_PER_SEC;
+      deadline.tv_nsec = deadline_ns % NANO_SEC_PER_SEC;
+      int result;
+      do
+      {
+        result = clock_nanosleep(CLOCK_MONOTONIC,TIMER_ABSTIME,&deadline,0);
+      } while (result == EINTR);
+      timespec time_now;
+      clock_gettime(CLOCK_MONOTONIC,&time_now);
+      int64_t late_ns = (int64_t)(time_now.tv_sec - deadline.tv_sec) * NANO_SEC_PER_SEC +
+        (time_now.tv_nsec - deadline.tv_nsec);
+      if (late_ns > (int64_t)__atomic_load_n(&state.period_ns,__ATOMIC_ACQUIRE))
+      {
+        __atomic_add_fetch(&state.overrun_count,1,__ATOMIC_ACQ_REL);
+      }
+      Isr isr = __atomic_load_n(&state.isr,__ATOMIC_ACQUIRE);
+      noInterrupts();
+      isr();
+      interrupts();
+    }
+    return 0;
+  }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------------------
+// Functor.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef FUNCTOR_H
+#define FUNCTOR_H
+#include <stddef.h>
+#include <string.h>
+
+
+template <typename P1>
+class Functor1
+{
+public:
+  typedef void (*Thunk)(const Functor1 &, P1);
+  enum{STORAGE_SIZE=2*sizeof(void *)};
+  Functor1() :
+  callee_(0),
+  thunk_(0) {}
+  Functor1(void * callee,
+    Thunk thunk,
+    const void * function,
+    size_t function_size) :
+  callee_(callee),
+  thunk_(thunk)
+  {
+    memcpy(function_,function,function_size);
+  }
+  void operator()(P1 p1) const
+  {
+    thunk_(*this,p1);
+  }
+  explicit operator bool() const
+  {
+    return thunk_ != 0;
+  }
+  void * callee_;
+  unsigned char function_[STORAGE_SIZE];
+private:
+  Thunk thunk_;
+};
+
+template <typename P1, typename Function>
+struct FunctionTranslator1
+{
+  static void thunk(const Functor1<P1> & functor,
+    P1 p1)
+  {
+    Function function;
+    memcpy(&function,functor.function_,sizeof(Function));
+    function(p1);
+  }
+};
+
+template <typename P1, typename Callee, typename MemberFunction>
+struct MemberTranslator1
+{
+  static void thunk(const Functor1<P1> & functor,
+    P1 p1)
+  {
+    MemberFunction member_function;
+    memcpy(&member_function,functor.function_,sizeof(MemberFunction));
+    (static_cast<Callee *>(functor.callee_)->*member_function)(p1);
+  }
+};
+
+template <typename P1, typename Function>
+Functor1<P1> makeFunctor(Functor1<P1> *,
+  Function function)
+{
+  static_assert(sizeof(Function) <= Functor1<P1>::STORAGE_SIZE,"function too large");
+  return Functor1<P1>(0,&FunctionTranslator1<P1,Function>::thunk,&function,sizeof(Function));
+}
+
+template <typename P1, typename Callee, typename MemberFunction>
+Functor1<P1> makeFunctor(Functor1<P1> *,
+  Callee & callee,
+  MemberFunction member_function)
+{
+  static_assert(sizeof(MemberFunction) <= Functor1<P1>::STORAGE_SIZE,"member function too large");
+  return Functor1<P1>(&callee,&MemberTranslator1<P1,Callee,MemberFunction>::thunk,&member_function,sizeof(MemberFunction));
+}
+
+#endif
@@ -0,0 +1,42 @@
+// ----------------------------------------------------------------------------
+// HostTest.h
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+#include <stdio.h>
+
+
+extern int host_test_failure_count;
+
+#define HOST_TEST_DEFINE int host_test_failure_count = 0
+
+#define CHECK(condition) \
+  do \
+  { \
+    if (!(condition)) \
+    { \
+      ++host_test_failure_count; \
+      printf("%s:%d: CHECK(%s) failed\n",__FILE__,__LINE__,#condition); \
+    } \
+  } while (0)
+
+#define CHECK_EQUAL(expected,actual) \
+  do \
+  { \
+    long long expected_value = (long long)(expected); \
+    long long actual_value = (long long)(actual); \
+    if (expected_value != actual_value) \
+    { \
+      ++host_test_failure_count; \
+      printf("%s:%d: CHECK_EQUAL(%s,%s) failed: %lld != %lld\n",__FILE__,__LINE__,#expected,#actual,expected_value,actual_value); \
+    } \
+  } while (0)
+
+#define HOST_TEST_RESULT(name) \
+  ((host_test_failure_count == 0) ? (printf("%s: passed\n",name), 0) : (printf("%s: %d failed\n",name,host_test_failure_count), 1))
+
+#endif
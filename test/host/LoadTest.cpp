@@ -0,0 +1,122 @@
+// ----------------------------------------------------------------------------
+// LoadTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+enum{HANDLER_COUNT=2};
+const uint32_t COST_FAST_US = 100;
+const uint32_t COST_SLOW_US = 300;
+const uint16_t OVERHEAD_US = 10;
+
+EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> event_controller;
+EventHandler handlers[HANDLER_COUNT];
+
+void idleHandler(int)
+{
+}
+
+EventId addHandlerEvent(uint8_t handler,
+  uint32_t delay,
+  uint32_t period_ms)
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,idleHandler);
+  EventId event_id = event_controller.addInfiniteRecurringEventUsingDelay(functor,delay,period_ms);
+  event_controller.setHandler(event_id,handler);
+  event_controller.enable(event_id);
+  return event_id;
+}
+
+void checkHyperperiod()
+{
+  addHandlerEvent(0,4,4);
+  addHandlerEvent(1,6,6);
+
+  EventLoad load = event_controller.analyzeLoad(COST_SLOW_US + COST_FAST_US - 1);
+  CHECK_EQUAL(6 + 12,load.horizon);
+  CHECK_EQUAL(6,load.tick_count);
+  CHECK_EQUAL(COST_SLOW_US + COST_FAST_US,load.cost_max_us);
+  CHECK_EQUAL(12,load.cost_max_tick);
+  CHECK_EQUAL(2,load.events_max);
+  CHECK_EQUAL(12,load.events_max_tick);
+  CHECK_EQUAL(1,load.overrun_count);
+  CHECK_EQUAL(12,load.overrun_first_tick);
+  CHECK_EQUAL((4 * COST_FAST_US + 3 * COST_SLOW_US) / 18,load.cost_average_us);
+  CHECK_EQUAL(0,load.unknown_cost_count);
+
+  load = event_controller.analyzeLoad(COST_SLOW_US - 1);
+  CHECK_EQUAL(3,load.overrun_count);
+  CHECK_EQUAL(6,load.overrun_first_tick);
+
+  load = event_controller.analyzeLoad(COST_SLOW_US + COST_FAST_US,OVERHEAD_US);
+  CHECK_EQUAL(COST_SLOW_US + COST_FAST_US + 2 * OVERHEAD_US,load.cost_max_us);
+  CHECK_EQUAL(1,load.overrun_count);
+
+  load = event_controller.analyzeLoad(COST_SLOW_US + COST_FAST_US,0,10);
+  CHECK_EQUAL(10,load.horizon);
+  CHECK_EQUAL(3,load.tick_count);
+  CHECK_EQUAL(COST_SLOW_US,load.cost_max_us);
+  CHECK_EQUAL(6,load.cost_max_tick);
+  CHECK_EQUAL(0,load.overrun_count);
+  event_controller.removeAllEvents();
+}
+
+void checkElapsed()
+{
+  addHandlerEvent(0,3,5);
+  EventTimerHost::tick(4);
+  addHandlerEvent(1,2,10);
+  EventLoad load = event_controller.analyzeLoad(COST_SLOW_US);
+  CHECK_EQUAL(4 + 10,load.horizon);
+  CHECK_EQUAL(5,load.tick_count);
+  CHECK_EQUAL(COST_SLOW_US,load.cost_max_us);
+  CHECK_EQUAL(2,load.cost_max_tick);
+  CHECK_EQUAL(1,load.events_max);
+  CHECK_EQUAL(0,load.overrun_count);
+  event_controller.removeAllEvents();
+}
+
+void checkUnknownCost()
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,idleHandler);
+  addHandlerEvent(0,2,2);
+  EventId functor_event = event_controller.addInfiniteRecurringEventUsingDelay(functor,2,2);
+  event_controller.enable(functor_event);
+  EventId disabled_event = addHandlerEvent(1,1,1);
+  event_controller.disable(disabled_event);
+  EventLoad load = event_controller.analyzeLoad(COST_FAST_US);
+  CHECK_EQUAL(1,load.unknown_cost_count);
+  CHECK_EQUAL(2 + 2,load.horizon);
+  CHECK_EQUAL(2,load.tick_count);
+  CHECK_EQUAL(2,load.events_max);
+  CHECK_EQUAL(COST_FAST_US,load.cost_max_us);
+  CHECK_EQUAL(0,load.overrun_count);
+  event_controller.removeAllEvents();
+}
+
+int main()
+{
+  handlers[0].functor = makeFunctor((Functor1<int> *)0,idleHandler);
+  handlers[0].cost_us = COST_FAST_US;
+  handlers[1].functor = makeFunctor((Functor1<int> *)0,idleHandler);
+  handlers[1].cost_us = COST_SLOW_US;
+  event_controller.setup();
+  event_controller.setHandlerTable(handlers,HANDLER_COUNT);
+
+  checkHyperperiod();
+  checkElapsed();
+  checkUnknownCost();
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  return HOST_TEST_RESULT("LoadTest");
+}
@@ -0,0 +1,69 @@
+// ----------------------------------------------------------------------------
+// PeriodTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+enum{FIRE_COUNT=30};
+enum{START_DELAY=10};
+
+EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> event_controller;
+uint32_t fire_ticks[FIRE_COUNT];
+int fire_count = 0;
+
+void fireHandler(int)
+{
+  if (fire_count < FIRE_COUNT)
+  {
+    fire_ticks[fire_count] = event_controller.getTicks();
+  }
+  ++fire_count;
+}
+
+void checkThirds(uint32_t time)
+{
+  Functor1<int> fire_functor = makeFunctor((Functor1<int> *)0,fireHandler);
+  event_controller.setup();
+  event_controller.setTime(time);
+  fire_count = 0;
+  uint32_t ticks_start = event_controller.getTicks();
+
+  EventId event_id = event_controller.addRecurringEventUsingDelay(fire_functor,START_DELAY,EventPeriod(1000,3),FIRE_COUNT);
+  Event event = event_controller.getEvent(event_id);
+  CHECK_EQUAL(333,event.period);
+  CHECK_EQUAL(333,event.period_ms);
+  CHECK_EQUAL(1,event.period_remainder);
+  CHECK_EQUAL(3,event.period_denominator);
+  event_controller.enable(event_id);
+
+  EventTimerHost::tick(START_DELAY + 1000 * (FIRE_COUNT / 3));
+  CHECK_EQUAL(FIRE_COUNT,fire_count);
+  for (int fire=0; fire<FIRE_COUNT; ++fire)
+  {
+    CHECK_EQUAL(START_DELAY + 1000 * (fire / 3) + 333 * (fire % 3),(uint32_t)(fire_ticks[fire] - ticks_start));
+  }
+  for (int fire=1; fire<FIRE_COUNT; ++fire)
+  {
+    CHECK_EQUAL(((fire % 3) == 0) ? 334 : 333,(uint32_t)(fire_ticks[fire] - fire_ticks[fire - 1]));
+  }
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+  event_controller.removeAllEvents();
+}
+
+int main()
+{
+  checkThirds(0);
+  checkThirds(0xFFFFFFFF - 4321);
+
+  return HOST_TEST_RESULT("PeriodTest");
+}
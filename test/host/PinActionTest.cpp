@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------
+// PinActionTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+EventController<8,1000,false,EventTimerHost> event_controller;
+int functor_count = 0;
+
+void countHandler(int)
+{
+  ++functor_count;
+}
+
+int main()
+{
+  Functor1<int> count_functor = makeFunctor((Functor1<int> *)0,countHandler);
+  event_controller.setup();
+
+  const uint8_t PWM_PIN = 10;
+  const uint8_t NEIGHBOR_PIN = 11;
+  digitalWrite(NEIGHBOR_PIN,HIGH);
+  EventIdPair pwm = event_controller.addPwmUsingDelay(count_functor,count_functor,10,20,5,2);
+  event_controller.setPinActions(pwm,PWM_PIN);
+  event_controller.enable(pwm);
+  CHECK_EQUAL(EVENT_ACTION_PIN_HIGH,event_controller.getEvent(pwm.event_id_0).action);
+  CHECK_EQUAL(EVENT_ACTION_PIN_LOW,event_controller.getEvent(pwm.event_id_1).action);
+  EventTimerHost::tick(9);
+  CHECK_EQUAL(LOW,digitalRead(PWM_PIN));
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(HIGH,digitalRead(PWM_PIN));
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(LOW,digitalRead(PWM_PIN));
+  EventTimerHost::tick(15);
+  CHECK_EQUAL(HIGH,digitalRead(PWM_PIN));
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(LOW,digitalRead(PWM_PIN));
+  CHECK_EQUAL(HIGH,digitalRead(NEIGHBOR_PIN));
+  CHECK_EQUAL(0,functor_count);
+  EventTimerHost::tick(40);
+  CHECK_EQUAL(LOW,digitalRead(PWM_PIN));
+  CHECK_EQUAL(8,event_controller.eventsAvailable());
+
+  const uint8_t TOGGLE_PIN = 26;
+  EventId toggle = event_controller.addRecurringEventUsingDelay(count_functor,4,4,4);
+  event_controller.setPinAction(toggle,TOGGLE_PIN,EVENT_ACTION_PIN_TOGGLE);
+  event_controller.enable(toggle);
+  uint32_t toggle_register = host_ports[3].out;
+  for (uint8_t toggle_index=0; toggle_index<4; ++toggle_index)
+  {
+    EventTimerHost::tick(4);
+    toggle_register ^= digitalPinToBitMask(TOGGLE_PIN);
+    CHECK_EQUAL(toggle_register,host_ports[3].out);
+  }
+  CHECK_EQUAL(0,functor_count);
+
+  const uint8_t INVALID_PIN = 200;
+  EventId invalid = event_controller.addEventUsingDelay(count_functor,1);
+  event_controller.setPinAction(invalid,INVALID_PIN,EVENT_ACTION_PIN_HIGH);
+  event_controller.enable(invalid);
+  CHECK_EQUAL(EVENT_ACTION_FUNCTOR,event_controller.getEvent(invalid).action);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(1,functor_count);
+
+  return HOST_TEST_RESULT("PinActionTest");
+}
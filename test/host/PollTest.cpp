@@ -0,0 +1,100 @@
+// ----------------------------------------------------------------------------
+// PollTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerPolled.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+enum{DISPATCH_COUNT_MAX=32};
+
+EventController<EVENT_COUNT_MAX,1000,false,EventTimerPolled> event_controller;
+int dispatch_args[DISPATCH_COUNT_MAX];
+uint32_t dispatch_times[DISPATCH_COUNT_MAX];
+int dispatch_count = 0;
+
+void recordHandler(int arg)
+{
+  if (dispatch_count < DISPATCH_COUNT_MAX)
+  {
+    dispatch_args[dispatch_count] = arg;
+  }
+  ++dispatch_count;
+}
+
+void pollAfter(uint32_t duration_us)
+{
+  host_micros = host_micros + duration_us;
+  event_controller.poll();
+}
+
+int main()
+{
+  Functor1<int> record_functor = makeFunctor((Functor1<int> *)0,recordHandler);
+  host_micros = 0;
+  event_controller.setup();
+
+  EventId recurring_3 = event_controller.addRecurringEventUsingDelay(record_functor,3,3,4,3);
+  event_controller.enable(recurring_3);
+  EventId recurring_5 = event_controller.addRecurringEventUsingDelay(record_functor,5,5,2,5);
+  event_controller.enable(recurring_5);
+  EventId single = event_controller.addEventUsingDelay(record_functor,7,7);
+  event_controller.enable(single);
+  pollAfter(20000);
+  CHECK_EQUAL(3,dispatch_count);
+  CHECK_EQUAL(17000,event_controller.getPollLagMax());
+  for (int poll_index=0; poll_index<20; ++poll_index)
+  {
+    pollAfter(1000);
+  }
+  const int DISPATCH_ARGS_EXPECTED[] = {3,5,7,3,3,5,3};
+  const int DISPATCH_COUNT_EXPECTED = sizeof(DISPATCH_ARGS_EXPECTED) / sizeof(DISPATCH_ARGS_EXPECTED[0]);
+  CHECK_EQUAL(DISPATCH_COUNT_EXPECTED,dispatch_count);
+  for (int dispatch_index=0; dispatch_index<DISPATCH_COUNT_EXPECTED; ++dispatch_index)
+  {
+    CHECK_EQUAL(DISPATCH_ARGS_EXPECTED[dispatch_index],dispatch_args[dispatch_index]);
+  }
+  CHECK_EQUAL(17000,event_controller.getPollLagMax());
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  uint32_t ticks = event_controller.getTicks();
+  pollAfter(2000000000);
+  CHECK_EQUAL(ticks + 2000000,event_controller.getTicks());
+
+  ticks = event_controller.getTicks();
+  event_controller.slewTime(event_controller.getTime() + 4,2);
+  pollAfter(20000);
+  CHECK_EQUAL(ticks + 24,event_controller.getTicks());
+  CHECK_EQUAL(0,event_controller.getSlewRemaining());
+
+  ticks = event_controller.getTicks();
+  event_controller.slewTime(event_controller.getTime() + 1000,3);
+  pollAfter(1000000);
+  CHECK_EQUAL(ticks + 1333,event_controller.getTicks());
+  CHECK_EQUAL(667,event_controller.getSlewRemaining());
+  pollAfter(1500000);
+  CHECK_EQUAL(ticks + 3333,event_controller.getTicks());
+  CHECK_EQUAL(167,event_controller.getSlewRemaining());
+  pollAfter(1000000);
+  CHECK_EQUAL(ticks + 4500,event_controller.getTicks());
+  CHECK_EQUAL(0,event_controller.getSlewRemaining());
+
+  ticks = event_controller.getTicks();
+  event_controller.slewTime(event_controller.getTime() - 10,1);
+  pollAfter(4000);
+  CHECK_EQUAL(ticks,event_controller.getTicks());
+  CHECK_EQUAL(-6,event_controller.getSlewRemaining());
+  pollAfter(21000);
+  CHECK_EQUAL(ticks + 15,event_controller.getTicks());
+  CHECK_EQUAL(0,event_controller.getSlewRemaining());
+
+  return HOST_TEST_RESULT("PollTest");
+}
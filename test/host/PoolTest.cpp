@@ -0,0 +1,229 @@
+// ----------------------------------------------------------------------------
+// PoolTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+const uint8_t QUOTA = 3;
+
+typedef EventPool<EVENT_COUNT_MAX> Pool;
+typedef EventController<EVENT_COUNT_MAX,1000,true,EventTimerHost> SharedController;
+
+Pool shared_pool;
+SharedController controller_a(shared_pool);
+SharedController controller_b(shared_pool);
+
+void idleHandler(int)
+{
+}
+
+bool indicesUnique(const uint8_t * indices,
+  uint8_t index_count)
+{
+  for (uint8_t i=0; i<index_count; ++i)
+  {
+    if (indices[i] >= EVENT_COUNT_MAX)
+    {
+      return false;
+    }
+    for (uint8_t j=i+1; j<index_count; ++j)
+    {
+      if (indices[i] == indices[j])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void checkOwners()
+{
+  Pool pool;
+  for (uint8_t owner=0; owner<Pool::OWNER_COUNT_MAX; ++owner)
+  {
+    CHECK_EQUAL(owner,pool.addOwner());
+    CHECK_EQUAL(EVENT_COUNT_MAX,pool.getQuota(owner));
+  }
+  CHECK_EQUAL(Pool::OWNER_NONE,pool.addOwner());
+  CHECK_EQUAL(0,pool.getQuota(Pool::OWNER_COUNT_MAX));
+  CHECK_EQUAL(0,pool.getAvailable(Pool::OWNER_COUNT_MAX));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(Pool::OWNER_COUNT_MAX));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(Pool::OWNER_NONE));
+  pool.setQuota(Pool::OWNER_COUNT_MAX,1);
+  CHECK_EQUAL(0,pool.getQuota(Pool::OWNER_COUNT_MAX));
+}
+
+void checkQuotas()
+{
+  Pool pool;
+  uint8_t owner_0 = pool.addOwner();
+  uint8_t owner_1 = pool.addOwner();
+  pool.setQuota(owner_0,QUOTA);
+  CHECK_EQUAL(QUOTA,pool.getQuota(owner_0));
+  CHECK_EQUAL(QUOTA,pool.getAvailable(owner_0));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.getAvailable(owner_1));
+
+  uint8_t indices[EVENT_COUNT_MAX];
+  for (uint8_t i=0; i<QUOTA; ++i)
+  {
+    indices[i] = pool.allocate(owner_0);
+    CHECK(pool.owns(owner_0,indices[i]));
+    CHECK(!pool.owns(owner_1,indices[i]));
+  }
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(owner_0));
+  CHECK_EQUAL(QUOTA,pool.getCount(owner_0));
+  CHECK_EQUAL(0,pool.getAvailable(owner_0));
+  CHECK_EQUAL(EVENT_COUNT_MAX - QUOTA,pool.getAvailable(owner_1));
+
+  for (uint8_t i=QUOTA; i<EVENT_COUNT_MAX; ++i)
+  {
+    indices[i] = pool.allocate(owner_1);
+  }
+  CHECK(indicesUnique(indices,EVENT_COUNT_MAX));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(owner_1));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.getCount());
+  CHECK_EQUAL(0,pool.getAvailable(owner_1));
+
+  pool.setQuota(owner_0,QUOTA + 1);
+  CHECK_EQUAL(0,pool.getAvailable(owner_0));
+  pool.deallocate(indices[EVENT_COUNT_MAX - 1]);
+  CHECK_EQUAL(1,pool.getAvailable(owner_0));
+  CHECK_EQUAL(indices[EVENT_COUNT_MAX - 1],pool.allocate(owner_0));
+  CHECK_EQUAL(QUOTA + 1,pool.getCount(owner_0));
+  CHECK_EQUAL(EVENT_COUNT_MAX - QUOTA - 1,pool.getCount(owner_1));
+
+  pool.setQuota(owner_0,1);
+  CHECK_EQUAL(0,pool.getAvailable(owner_0));
+  pool.deallocate(indices[0]);
+  pool.deallocate(indices[0]);
+  CHECK_EQUAL(QUOTA,pool.getCount(owner_0));
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,pool.getCount());
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(owner_0));
+  pool.deallocate(EVENT_COUNT_MAX);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,pool.getCount());
+}
+
+void checkClaim()
+{
+  Pool pool;
+  uint8_t owner_0 = pool.addOwner();
+  uint8_t owner_1 = pool.addOwner();
+  pool.setQuota(owner_1,2);
+
+  CHECK(pool.claim(5,owner_0));
+  CHECK(pool.owns(owner_0,5));
+  CHECK(!pool.claim(5,owner_0));
+  CHECK(!pool.claim(5,owner_1));
+  CHECK(!pool.claim(EVENT_COUNT_MAX,owner_0));
+  CHECK(!pool.claim(3,Pool::OWNER_COUNT_MAX));
+  CHECK(pool.claim(0,owner_1));
+  CHECK(pool.claim(EVENT_COUNT_MAX - 1,owner_1));
+  CHECK(!pool.claim(2,owner_1));
+  CHECK_EQUAL(2,pool.getCount(owner_1));
+  CHECK_EQUAL(3,pool.getCount());
+
+  uint8_t indices[EVENT_COUNT_MAX];
+  indices[0] = 5;
+  indices[1] = 0;
+  indices[2] = EVENT_COUNT_MAX - 1;
+  for (uint8_t i=3; i<EVENT_COUNT_MAX; ++i)
+  {
+    indices[i] = pool.allocate(owner_0);
+  }
+  CHECK(indicesUnique(indices,EVENT_COUNT_MAX));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(owner_0));
+
+  pool.deallocate(5);
+  pool.deallocate(2);
+  CHECK(pool.claim(2,owner_0));
+  CHECK_EQUAL(5,pool.allocate(owner_0));
+  CHECK_EQUAL(EVENT_COUNT_MAX,pool.allocate(owner_0));
+}
+
+void checkHighWatermarks()
+{
+  Pool pool;
+  uint8_t owner_0 = pool.addOwner();
+  uint8_t owner_1 = pool.addOwner();
+  uint8_t indices[EVENT_COUNT_MAX];
+  for (uint8_t i=0; i<4; ++i)
+  {
+    indices[i] = pool.allocate(owner_0);
+  }
+  CHECK(pool.claim(EVENT_COUNT_MAX - 1,owner_1));
+  indices[4] = pool.allocate(owner_1);
+  CHECK_EQUAL(4,pool.getHighWatermark(owner_0));
+  CHECK_EQUAL(2,pool.getHighWatermark(owner_1));
+  CHECK_EQUAL(6,pool.getHighWatermark());
+
+  pool.deallocate(indices[0]);
+  pool.deallocate(indices[1]);
+  pool.deallocate(indices[4]);
+  CHECK_EQUAL(4,pool.getHighWatermark(owner_0));
+  CHECK_EQUAL(2,pool.getHighWatermark(owner_1));
+  CHECK_EQUAL(6,pool.getHighWatermark());
+
+  pool.resetHighWatermarks();
+  CHECK_EQUAL(2,pool.getHighWatermark(owner_0));
+  CHECK_EQUAL(1,pool.getHighWatermark(owner_1));
+  CHECK_EQUAL(3,pool.getHighWatermark());
+
+  pool.allocate(owner_1);
+  CHECK_EQUAL(2,pool.getHighWatermark(owner_1));
+  CHECK_EQUAL(4,pool.getHighWatermark());
+  CHECK_EQUAL(0,pool.getHighWatermark(Pool::OWNER_COUNT_MAX));
+}
+
+void checkSharedControllers()
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,idleHandler);
+  controller_a.setup();
+  controller_b.setup();
+  shared_pool.setQuota(0,QUOTA);
+  CHECK_EQUAL(QUOTA,controller_a.eventsAvailable());
+  CHECK_EQUAL(EVENT_COUNT_MAX,controller_b.eventsAvailable());
+
+  EventId event_ids_a[QUOTA];
+  for (uint8_t i=0; i<QUOTA; ++i)
+  {
+    event_ids_a[i] = controller_a.addEventUsingDelay(functor,100);
+    CHECK(event_ids_a[i].index < EVENT_COUNT_MAX);
+  }
+  CHECK_EQUAL(EVENT_COUNT_MAX,controller_a.addEventUsingDelay(functor,100).index);
+  CHECK_EQUAL(EVENT_COUNT_MAX - QUOTA,controller_b.eventsAvailable());
+
+  EventId event_id_b = controller_b.addEventUsingDelay(functor,100);
+  CHECK(event_id_b.index < EVENT_COUNT_MAX);
+  controller_b.remove(event_ids_a[0]);
+  CHECK_EQUAL(QUOTA,shared_pool.getCount(0));
+  controller_a.removeAllEvents();
+  CHECK_EQUAL(0,shared_pool.getCount(0));
+  CHECK_EQUAL(1,shared_pool.getCount(1));
+  CHECK_EQUAL(QUOTA,shared_pool.getHighWatermark(0));
+  CHECK_EQUAL(1,shared_pool.getHighWatermark(1));
+  CHECK_EQUAL(QUOTA + 1,shared_pool.getHighWatermark());
+  controller_b.removeAllEvents();
+  CHECK_EQUAL(0,shared_pool.getCount());
+}
+
+int main()
+{
+  checkOwners();
+  checkQuotas();
+  checkClaim();
+  checkHighWatermarks();
+  checkSharedControllers();
+
+  return HOST_TEST_RESULT("PoolTest");
+}
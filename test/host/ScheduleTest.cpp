@@ -0,0 +1,252 @@
+// ----------------------------------------------------------------------------
+// ScheduleTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+enum{HANDLER_COUNT=1};
+
+typedef EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> ScheduleController;
+
+ScheduleController event_controller;
+EventHandler handlers[HANDLER_COUNT];
+uint8_t schedule[ScheduleController::SCHEDULE_HEADER_SIZE + (size_t)EVENT_COUNT_MAX * ScheduleController::SCHEDULE_RECORD_SIZE];
+int handler_count = 0;
+int functor_count = 0;
+
+void handlerHandler(int)
+{
+  ++handler_count;
+}
+
+void functorHandler(int)
+{
+  ++functor_count;
+}
+
+class ScheduleStream : public Stream
+{
+public:
+  ScheduleStream() :
+  size_(0),
+  position_(0) {}
+  size_t write(uint8_t byte)
+  {
+    if (size_ >= sizeof(buffer_))
+    {
+      return 0;
+    }
+    buffer_[size_++] = byte;
+    return 1;
+  }
+  int available()
+  {
+    return size_ - position_;
+  }
+  int read()
+  {
+    return (position_ < size_) ? buffer_[position_++] : -1;
+  }
+  uint8_t * getBuffer()
+  {
+    return buffer_;
+  }
+private:
+  uint8_t buffer_[sizeof(schedule)];
+  size_t size_;
+  size_t position_;
+};
+
+Event catchUpReference(Event event,
+  uint32_t ticks)
+{
+  while (((event.period > 0) || (event.period_remainder > 0)) &&
+    ((int32_t)(ticks - event.time) > 0) &&
+    (event.infinite || (event.inc < event.count)))
+  {
+    event.time += event.period;
+    event.phase += event.period_remainder;
+    if (event.phase >= event.period_denominator)
+    {
+      event.phase -= event.period_denominator;
+      ++event.time;
+    }
+    ++event.inc;
+  }
+  return event;
+}
+
+void checkHandlers()
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,functorHandler);
+  EventId recurring = event_controller.addInfiniteRecurringEventUsingDelay(functor,10,10);
+  event_controller.setHandler(recurring,0);
+  event_controller.enable(recurring);
+  EventId timeout_handler = event_controller.addTimeout(functor,5);
+  event_controller.setHandler(timeout_handler,0);
+  event_controller.addTimeout(functor,5);
+  event_controller.addTimeout(functor,50);
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(1,functor_count);
+  CHECK_EQUAL(1,handler_count);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 4,event_controller.eventsAvailable());
+
+  size_t schedule_size = event_controller.saveSchedule(schedule,sizeof(schedule));
+  CHECK_EQUAL(event_controller.getScheduleSize(),schedule_size);
+  CHECK(event_controller.restoreSchedule(schedule,schedule_size,0));
+  CHECK_EQUAL(EVENT_COUNT_MAX - 2,event_controller.eventsAvailable());
+  CHECK(event_controller.getEvent(recurring).armed == false);
+  CHECK(event_controller.getEvent(timeout_handler).armed);
+  EventTimerHost::tick(5);
+  CHECK_EQUAL(2,handler_count);
+  CHECK_EQUAL(1,functor_count);
+  event_controller.removeAllEvents();
+}
+
+void checkPhase()
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,functorHandler);
+  EventId fractional = event_controller.addInfiniteRecurringEventUsingDelay(functor,1,EventPeriod(10,3));
+  event_controller.setHandler(fractional,0);
+  event_controller.enable(fractional);
+  EventTimerHost::tick(5);
+  Event saved = event_controller.getEvent(fractional);
+  CHECK_EQUAL(3,saved.period);
+  CHECK_EQUAL(1,saved.period_remainder);
+  CHECK_EQUAL(3,saved.period_denominator);
+  CHECK_EQUAL(2,saved.phase);
+
+  size_t schedule_size = event_controller.saveSchedule(schedule,sizeof(schedule));
+  CHECK(event_controller.restoreSchedule(schedule,schedule_size,0));
+  Event restored = event_controller.getEvent(fractional);
+  CHECK_EQUAL(saved.time,restored.time);
+  CHECK_EQUAL(saved.period,restored.period);
+  CHECK_EQUAL(saved.period_remainder,restored.period_remainder);
+  CHECK_EQUAL(saved.period_denominator,restored.period_denominator);
+  CHECK_EQUAL(saved.phase,restored.phase);
+  CHECK_EQUAL(saved.inc,restored.inc);
+  CHECK(restored.enabled);
+  event_controller.removeAllEvents();
+}
+
+void checkCatchUp()
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,functorHandler);
+  EventId fractional = event_controller.addInfiniteRecurringEventUsingDelay(functor,2,EventPeriod(100,7));
+  event_controller.setHandler(fractional,0);
+  event_controller.enable(fractional);
+  EventId finite = event_controller.addRecurringEventUsingDelay(functor,2,EventPeriod(20,3),5);
+  event_controller.setHandler(finite,0);
+  event_controller.enable(finite);
+  EventTimerHost::tick(10);
+  uint32_t ticks = event_controller.getTicks();
+  Event fractional_saved = event_controller.getEvent(fractional);
+  Event finite_saved = event_controller.getEvent(finite);
+  CHECK(fractional_saved.phase > 0);
+  CHECK(finite_saved.inc < 5);
+  size_t schedule_size = event_controller.saveSchedule(schedule,sizeof(schedule));
+
+  for (uint32_t elapsed=0; elapsed<=1000; elapsed+=7)
+  {
+    Event fractional_expected = fractional_saved;
+    fractional_expected.time -= elapsed;
+    fractional_expected = catchUpReference(fractional_expected,ticks);
+    Event finite_expected = finite_saved;
+    finite_expected.time -= elapsed;
+    finite_expected = catchUpReference(finite_expected,ticks);
+
+    CHECK(event_controller.restoreSchedule(schedule,schedule_size,elapsed));
+    Event fractional_restored = event_controller.getEvent(fractional);
+    CHECK_EQUAL(fractional_expected.time,fractional_restored.time);
+    CHECK_EQUAL(fractional_expected.phase,fractional_restored.phase);
+    CHECK_EQUAL(fractional_expected.inc,fractional_restored.inc);
+    CHECK((int32_t)(fractional_restored.time - ticks) >= 0);
+    Event finite_restored = event_controller.getEvent(finite);
+    CHECK_EQUAL(finite_expected.time,finite_restored.time);
+    CHECK_EQUAL(finite_expected.phase,finite_restored.phase);
+    CHECK_EQUAL(finite_expected.inc,finite_restored.inc);
+  }
+  CHECK_EQUAL(5,event_controller.getEvent(finite).inc);
+  CHECK(event_controller.getEvent(fractional).inc > 70);
+  event_controller.removeAllEvents();
+}
+
+void checkPinAction()
+{
+  const uint8_t PIN = 10;
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,functorHandler);
+  EventId pin_event = event_controller.addInfiniteRecurringEventUsingDelay(functor,4,4);
+  event_controller.setPinAction(pin_event,PIN,EVENT_ACTION_PIN_TOGGLE);
+  event_controller.enable(pin_event);
+  EventId register_event = event_controller.addInfiniteRecurringEventUsingDelay(functor,4,4);
+  event_controller.setRegisterAction(register_event,&host_ports[0].out,1,EVENT_ACTION_PIN_TOGGLE);
+  CHECK_EQUAL(0,event_controller.saveSchedule(schedule,sizeof(schedule)));
+  event_controller.remove(register_event);
+
+  size_t schedule_size = event_controller.saveSchedule(schedule,sizeof(schedule));
+  CHECK_EQUAL(event_controller.getScheduleSize(),schedule_size);
+  CHECK(event_controller.restoreSchedule(schedule,schedule_size,0));
+  Event restored = event_controller.getEvent(pin_event);
+  CHECK(restored.enabled);
+  CHECK_EQUAL(EVENT_ACTION_PIN_TOGGLE,restored.action);
+  CHECK_EQUAL(PIN,restored.pin);
+  CHECK(restored.port_register == portOutputRegister(digitalPinToPort(PIN)));
+  CHECK_EQUAL(digitalPinToBitMask(PIN),restored.port_bit_mask);
+  CHECK_EQUAL(LOW,digitalRead(PIN));
+  EventTimerHost::tick(4);
+  CHECK_EQUAL(HIGH,digitalRead(PIN));
+  EventTimerHost::tick(4);
+  CHECK_EQUAL(LOW,digitalRead(PIN));
+  event_controller.removeAllEvents();
+}
+
+void checkCrc()
+{
+  Functor1<int> functor = makeFunctor((Functor1<int> *)0,functorHandler);
+  EventId recurring = event_controller.addInfiniteRecurringEventUsingDelay(functor,10,10);
+  event_controller.setHandler(recurring,0);
+  event_controller.addInfiniteRecurringEventUsingDelay(functor,10,10);
+  size_t schedule_size = event_controller.saveSchedule(schedule,sizeof(schedule));
+  schedule[(size_t)ScheduleController::SCHEDULE_HEADER_SIZE + ScheduleController::SCHEDULE_RECORD_SIZE + 8] ^= 0x01;
+  CHECK(!event_controller.restoreSchedule(schedule,schedule_size,0));
+  CHECK_EQUAL(EVENT_COUNT_MAX - 2,event_controller.eventsAvailable());
+
+  ScheduleStream stream;
+  CHECK_EQUAL(event_controller.getScheduleSize(),event_controller.saveSchedule(stream));
+  stream.getBuffer()[(size_t)ScheduleController::SCHEDULE_HEADER_SIZE + ScheduleController::SCHEDULE_RECORD_SIZE - 1] ^= 0x80;
+  CHECK(!event_controller.restoreSchedule(stream,0));
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  ScheduleStream stream_valid;
+  event_controller.addInfiniteRecurringEventUsingDelay(functor,10,10);
+  schedule_size = event_controller.saveSchedule(stream_valid);
+  CHECK(event_controller.restoreSchedule(stream_valid,0));
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+  event_controller.removeAllEvents();
+}
+
+int main()
+{
+  handlers[0].functor = makeFunctor((Functor1<int> *)0,handlerHandler);
+  event_controller.setup();
+  event_controller.setHandlerTable(handlers,HANDLER_COUNT);
+
+  checkHandlers();
+  checkPhase();
+  checkCatchUp();
+  checkPinAction();
+  checkCrc();
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  return HOST_TEST_RESULT("ScheduleTest");
+}
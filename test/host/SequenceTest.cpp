@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------------
+// SequenceTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=4};
+enum{RECORD_COUNT_MAX=5};
+enum{PLAY_COUNT_MAX=16};
+
+EventController<EVENT_COUNT_MAX,100,false,EventTimerHost> event_controller;
+EventSequenceRecord records[RECORD_COUNT_MAX];
+uint32_t ticks_start = 0;
+uint32_t play_ticks[PLAY_COUNT_MAX];
+int play_args[PLAY_COUNT_MAX];
+int play_count = 0;
+uint32_t low_watermark_ticks[PLAY_COUNT_MAX];
+int low_watermark_count = 0;
+int refill_count = 0;
+
+void playHandler(int arg)
+{
+  if (play_count < PLAY_COUNT_MAX)
+  {
+    play_ticks[play_count] = event_controller.getTicks() - ticks_start;
+    play_args[play_count] = arg;
+  }
+  ++play_count;
+}
+
+void lowWatermarkHandler(int pending)
+{
+  CHECK_EQUAL(1,pending);
+  if (low_watermark_count < PLAY_COUNT_MAX)
+  {
+    low_watermark_ticks[low_watermark_count] = event_controller.getTicks() - ticks_start;
+  }
+  ++low_watermark_count;
+  if (refill_count == 0)
+  {
+    ++refill_count;
+    CHECK(event_controller.pushSequence(300,5));
+  }
+}
+
+void checkInvalid()
+{
+  Functor1<int> play_functor = makeFunctor((Functor1<int> *)0,playHandler);
+  CHECK(!event_controller.pushSequence(100,0));
+  CHECK_EQUAL(0,event_controller.getSequenceSpace());
+  CHECK(event_controller.addSequenceUsingDelay(play_functor,0,RECORD_COUNT_MAX).index >= EVENT_COUNT_MAX);
+  CHECK(event_controller.addSequenceUsingDelay(play_functor,records,1).index >= EVENT_COUNT_MAX);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+}
+
+void checkPlayback()
+{
+  Functor1<int> play_functor = makeFunctor((Functor1<int> *)0,playHandler);
+  Functor1<int> low_watermark_functor = makeFunctor((Functor1<int> *)0,lowWatermarkHandler);
+  ticks_start = event_controller.getTicks();
+  EventId sequence_id = event_controller.addSequenceUsingDelay(play_functor,records,RECORD_COUNT_MAX);
+  CHECK(sequence_id.index < EVENT_COUNT_MAX);
+  CHECK(event_controller.addSequenceUsingDelay(play_functor,records,RECORD_COUNT_MAX).index >= EVENT_COUNT_MAX);
+  CHECK_EQUAL(RECORD_COUNT_MAX - 1,event_controller.getSequenceSpace());
+  event_controller.setSequenceLowWatermark(1,low_watermark_functor);
+
+  CHECK(event_controller.pushSequence(1000,1));
+  CHECK(event_controller.pushSequence(250,2));
+  CHECK(event_controller.pushSequence(350,3));
+  CHECK(event_controller.pushSequence(500,4));
+  CHECK(!event_controller.pushSequence(500,-1));
+  CHECK_EQUAL(0,event_controller.getSequenceSpace());
+  CHECK(!event_controller.getEvent(sequence_id).armed);
+
+  EventTimerHost::tick(9);
+  CHECK_EQUAL(0,play_count);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(1,play_count);
+  EventTimerHost::tick(20);
+  CHECK_EQUAL(5,play_count);
+  CHECK_EQUAL(1,refill_count);
+  CHECK_EQUAL(2,low_watermark_count);
+  CHECK_EQUAL(1,event_controller.getSequenceUnderrunCount());
+  CHECK(event_controller.getEvent(sequence_id).armed);
+  CHECK_EQUAL(RECORD_COUNT_MAX - 1,event_controller.getSequenceSpace());
+
+  const uint32_t expected_ticks[] = {10,12,16,21,24};
+  for (int play_index=0; play_index<5; ++play_index)
+  {
+    CHECK_EQUAL(expected_ticks[play_index],play_ticks[play_index]);
+    CHECK_EQUAL(play_index + 1,play_args[play_index]);
+  }
+  CHECK_EQUAL(16,low_watermark_ticks[0]);
+  CHECK_EQUAL(21,low_watermark_ticks[1]);
+
+  EventTimerHost::tick(10);
+  CHECK_EQUAL(5,play_count);
+  CHECK(event_controller.pushSequence(700,6));
+  CHECK(!event_controller.getEvent(sequence_id).armed);
+  EventTimerHost::tick(6);
+  CHECK_EQUAL(5,play_count);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(6,play_count);
+  CHECK_EQUAL(40 + 7,play_ticks[5]);
+  CHECK_EQUAL(6,play_args[5]);
+  CHECK_EQUAL(2,event_controller.getSequenceUnderrunCount());
+  CHECK_EQUAL(2,low_watermark_count);
+
+  event_controller.remove(sequence_id);
+  CHECK(!event_controller.pushSequence(100,0));
+  CHECK_EQUAL(0,event_controller.getSequenceSpace());
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+}
+
+void checkRemainder()
+{
+  Functor1<int> play_functor = makeFunctor((Functor1<int> *)0,playHandler);
+  event_controller.setSequenceLowWatermark(0,Functor1<int>());
+  play_count = 0;
+  ticks_start = event_controller.getTicks();
+  EventId sequence_id = event_controller.addSequenceUsingDelay(play_functor,records,RECORD_COUNT_MAX,1);
+  CHECK(event_controller.pushSequence(0,0));
+  for (int record=1; record<RECORD_COUNT_MAX - 1; ++record)
+  {
+    CHECK(event_controller.pushSequence(150,record));
+  }
+  EventTimerHost::tick(20);
+  CHECK_EQUAL(RECORD_COUNT_MAX - 1,play_count);
+  const uint32_t expected_ticks[] = {0,1,3,4};
+  for (int play_index=0; play_index<RECORD_COUNT_MAX - 1; ++play_index)
+  {
+    CHECK_EQUAL(expected_ticks[play_index] + 10,play_ticks[play_index]);
+  }
+  CHECK_EQUAL(1,event_controller.getSequenceUnderrunCount());
+  event_controller.remove(sequence_id);
+}
+
+int main()
+{
+  event_controller.setup();
+
+  checkInvalid();
+  checkPlayback();
+  checkRemainder();
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  return HOST_TEST_RESULT("SequenceTest");
+}
@@ -0,0 +1,492 @@
+// ----------------------------------------------------------------------------
+// StressTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include <atomic>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=32};
+enum{TOKEN_COUNT_MAX=1<<21};
+enum{HANDLE_COUNT=48};
+enum{INTERRUPT_PERIOD_US=20};
+enum{QUIESCE_TICK_COUNT=200};
+enum{GROUP_COUNT=4};
+
+typedef EventController<EVENT_COUNT_MAX,100,false,EventTimerHost> StressController;
+
+enum TokenKind
+{
+  TOKEN_FINITE,
+  TOKEN_INFINITE,
+  TOKEN_PAIR,
+};
+
+enum Op
+{
+  OP_ADD_EVENT,
+  OP_ADD_RECURRING,
+  OP_ADD_INFINITE,
+  OP_ADD_PWM,
+  OP_ADD_TIMEOUT,
+  OP_ADD_OFFSET,
+  OP_REMOVE,
+  OP_REMOVE_PAIR,
+  OP_ENABLE,
+  OP_DISABLE,
+  OP_REPLACE,
+  OP_ADD_TO_GROUP,
+  OP_REMOVE_FROM_GROUP,
+  OP_ENABLE_GROUP,
+  OP_DISABLE_GROUP,
+  OP_REMOVE_GROUP,
+  OP_ARM,
+  OP_TRIGGER,
+  OP_KICK,
+  OP_COALESCE,
+  OP_CLEAR,
+  OP_SET_DEFERRED,
+  OP_DISPATCH_DEFERRED,
+  OP_COUNT,
+};
+
+struct Handle
+{
+  EventIdPair event_id_pair;
+  uint32_t token;
+  bool used;
+};
+
+StressController event_controller;
+Functor1<int> fire_functor;
+Functor1<int> stop_functor;
+Handle handles[HANDLE_COUNT];
+uint32_t random_state = 0x12345678;
+uint32_t token_count = 1;
+
+std::atomic<uint16_t> fire_counts[TOKEN_COUNT_MAX];
+std::atomic<uint8_t> stop_counts[TOKEN_COUNT_MAX];
+std::atomic<uint32_t> double_fire_count(0);
+std::atomic<uint32_t> double_stop_count(0);
+std::atomic<uint32_t> fire_after_stop_count(0);
+std::atomic<uint32_t> interrupt_count(0);
+uint8_t token_kinds[TOKEN_COUNT_MAX];
+uint16_t token_fire_max[TOKEN_COUNT_MAX];
+bool token_stop_attached[TOKEN_COUNT_MAX];
+bool token_cleared[TOKEN_COUNT_MAX];
+
+uint32_t randomNext()
+{
+  random_state ^= random_state << 13;
+  random_state ^= random_state >> 17;
+  random_state ^= random_state << 5;
+  return random_state;
+}
+
+uint32_t randomBelow(uint32_t bound)
+{
+  return randomNext() % bound;
+}
+
+double secondsNow()
+{
+  timespec time_now;
+  clock_gettime(CLOCK_MONOTONIC,&time_now);
+  return time_now.tv_sec + time_now.tv_nsec * 1e-9;
+}
+
+void fireHandler(int arg)
+{
+  if ((arg <= 0) || (arg >= TOKEN_COUNT_MAX))
+  {
+    return;
+  }
+  uint16_t fire_count = fire_counts[arg].fetch_add(1) + 1;
+  if ((token_kinds[arg] != TOKEN_INFINITE) && (fire_count > token_fire_max[arg]))
+  {
+    ++double_fire_count;
+  }
+  if ((token_kinds[arg] != TOKEN_PAIR) && (stop_counts[arg].load() > 0))
+  {
+    ++fire_after_stop_count;
+  }
+}
+
+void stopHandler(int arg)
+{
+  if ((arg <= 0) || (arg >= TOKEN_COUNT_MAX))
+  {
+    return;
+  }
+  if (stop_counts[arg].fetch_add(1) > 0)
+  {
+    ++double_stop_count;
+  }
+}
+
+void interruptSignalHandler(int)
+{
+  ++interrupt_count;
+  hostRaiseInterrupt();
+}
+
+void setInterruptTimer(uint32_t period_us)
+{
+  itimerval timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = period_us;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_REAL,&timer,0);
+}
+
+bool eventMatches(const EventId event_id,
+  uint32_t token)
+{
+  Event event = event_controller.getEvent(event_id);
+  return (event_id.index < EVENT_COUNT_MAX) &&
+    !event.free &&
+    (event.time_start == event_id.time_start) &&
+    (event.arg == (int)token);
+}
+
+void verifyStopAttached(const EventId event_id,
+  uint32_t token)
+{
+  noInterrupts();
+  Event event = event_controller.getEvent(event_id);
+  if (eventMatches(event_id,token) && event.functor_stop)
+  {
+    token_stop_attached[token] = true;
+  }
+  interrupts();
+}
+
+Handle & pickHandle()
+{
+  return handles[randomBelow(HANDLE_COUNT)];
+}
+
+void storeHandle(const EventIdPair event_id_pair,
+  uint32_t token)
+{
+  Handle & handle = pickHandle();
+  if (handle.used)
+  {
+    event_controller.remove(handle.event_id_pair);
+  }
+  handle.event_id_pair = event_id_pair;
+  handle.token = token;
+  handle.used = true;
+}
+
+uint32_t newToken(TokenKind kind,
+  uint16_t fire_max)
+{
+  uint32_t token = token_count++;
+  token_kinds[token] = kind;
+  token_fire_max[token] = fire_max;
+  return token;
+}
+
+void finishAdd(const EventIdPair event_id_pair,
+  uint32_t token)
+{
+  if (event_id_pair.event_id_0.index >= EVENT_COUNT_MAX)
+  {
+    --token_count;
+    return;
+  }
+  event_controller.addStopFunctor(event_id_pair.event_id_0,stop_functor);
+  if (randomBelow(8) != 0)
+  {
+    event_controller.enable(event_id_pair);
+  }
+  verifyStopAttached(event_id_pair.event_id_0,token);
+  storeHandle(event_id_pair,token);
+}
+
+void runOp(Op op)
+{
+  switch (op)
+  {
+    case OP_ADD_EVENT:
+    {
+      uint32_t token = newToken(TOKEN_FINITE,1);
+      EventIdPair event_id_pair;
+      event_id_pair.event_id_0 = event_controller.addEventUsingDelayMicros(fire_functor,100 * (1 + randomBelow(8)),token);
+      finishAdd(event_id_pair,token);
+      break;
+    }
+    case OP_ADD_RECURRING:
+    {
+      uint16_t count = 1 + randomBelow(4);
+      uint32_t token = newToken(TOKEN_FINITE,count);
+      EventIdPair event_id_pair;
+      event_id_pair.event_id_0 = event_controller.addRecurringEventUsingDelayMicros(fire_functor,100 * (1 + randomBelow(8)),100 * (1 + randomBelow(5)),count,token);
+      finishAdd(event_id_pair,token);
+      break;
+    }
+    case OP_ADD_INFINITE:
+    {
+      uint32_t token = newToken(TOKEN_INFINITE,0);
+      EventIdPair event_id_pair;
+      event_id_pair.event_id_0 = event_controller.addInfiniteRecurringEventUsingDelayMicros(fire_functor,100 * (1 + randomBelow(8)),100 * (1 + randomBelow(5)),token);
+      finishAdd(event_id_pair,token);
+      break;
+    }
+    case OP_ADD_PWM:
+    {
+      uint16_t count = 1 + randomBelow(3);
+      uint32_t token = newToken(TOKEN_PAIR,2 * count);
+      EventIdPair event_id_pair = event_controller.addPwmUsingDelayMicros(fire_functor,fire_functor,100 * (1 + randomBelow(8)),400,200,count,token);
+      finishAdd(event_id_pair,token);
+      break;
+    }
+    case OP_ADD_TIMEOUT:
+    {
+      uint32_t token = newToken(TOKEN_INFINITE,0);
+      EventIdPair event_id_pair;
+      event_id_pair.event_id_0 = event_controller.addTimeoutMicros(fire_functor,100 * (2 + randomBelow(8)),token);
+      finishAdd(event_id_pair,token);
+      break;
+    }
+    case OP_ADD_OFFSET:
+    {
+      Handle & origin = pickHandle();
+      uint32_t token = newToken(TOKEN_FINITE,1);
+      EventIdPair event_id_pair;
+      event_id_pair.event_id_0 = event_controller.addEventUsingOffset(fire_functor,origin.event_id_pair.event_id_0,randomBelow(2),token);
+      finishAdd(event_id_pair,token);
+      break;
+    }
+    case OP_REMOVE:
+    {
+      Handle & handle = pickHandle();
+      event_controller.remove(handle.event_id_pair.event_id_0);
+      break;
+    }
+    case OP_REMOVE_PAIR:
+    {
+      Handle & handle = pickHandle();
+      event_controller.remove(handle.event_id_pair);
+      break;
+    }
+    case OP_ENABLE:
+    {
+      event_controller.enable(pickHandle().event_id_pair);
+      break;
+    }
+    case OP_DISABLE:
+    {
+      event_controller.disable(pickHandle().event_id_pair);
+      break;
+    }
+    case OP_REPLACE:
+    {
+      event_controller.replaceFunctors(pickHandle().event_id_pair,fire_functor,fire_functor);
+      break;
+    }
+    case OP_ADD_TO_GROUP:
+    {
+      event_controller.addToGroup(pickHandle().event_id_pair,1 << randomBelow(GROUP_COUNT));
+      break;
+    }
+    case OP_REMOVE_FROM_GROUP:
+    {
+      event_controller.removeFromGroup(pickHandle().event_id_pair,1 << randomBelow(GROUP_COUNT));
+      break;
+    }
+    case OP_ENABLE_GROUP:
+    {
+      event_controller.enableGroup(1 << randomBelow(GROUP_COUNT));
+      break;
+    }
+    case OP_DISABLE_GROUP:
+    {
+      event_controller.disableGroup(1 << randomBelow(GROUP_COUNT));
+      break;
+    }
+    case OP_REMOVE_GROUP:
+    {
+      event_controller.removeGroup(1 << randomBelow(GROUP_COUNT));
+      break;
+    }
+    case OP_ARM:
+    {
+      event_controller.armUsingDelayMicros(pickHandle().event_id_pair,100 * randomBelow(4));
+      break;
+    }
+    case OP_TRIGGER:
+    {
+      event_controller.trigger(pickHandle().event_id_pair);
+      break;
+    }
+    case OP_KICK:
+    {
+      event_controller.kick(pickHandle().event_id_pair.event_id_0);
+      break;
+    }
+    case OP_COALESCE:
+    {
+      event_controller.coalesce(pickHandle().event_id_pair.event_id_0,pickHandle().event_id_pair.event_id_0);
+      break;
+    }
+    case OP_CLEAR:
+    {
+      Handle & handle = pickHandle();
+      noInterrupts();
+      if (handle.used && (token_kinds[handle.token] != TOKEN_PAIR) && eventMatches(handle.event_id_pair.event_id_0,handle.token))
+      {
+        token_cleared[handle.token] = true;
+        event_controller.clear(handle.event_id_pair.event_id_0);
+      }
+      interrupts();
+      break;
+    }
+    case OP_SET_DEFERRED:
+    {
+      event_controller.setDeferred(pickHandle().event_id_pair);
+      break;
+    }
+    case OP_DISPATCH_DEFERRED:
+    {
+      event_controller.dispatchDeferred();
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+bool batchArmed(uint8_t event_index)
+{
+  for (uint8_t depth=0; depth<EVENT_COUNT_MAX; ++depth)
+  {
+    Event event = event_controller.getEvent(event_index);
+    if (!event.batched)
+    {
+      return event.armed;
+    }
+    uint8_t event_index_previous = 0;
+    while ((event_index_previous < EVENT_COUNT_MAX) &&
+      (event_controller.getEvent(event_index_previous).batch_next != event_index))
+    {
+      ++event_index_previous;
+    }
+    if (event_index_previous >= EVENT_COUNT_MAX)
+    {
+      return false;
+    }
+    event_index = event_index_previous;
+  }
+  return false;
+}
+
+void checkQuiescent()
+{
+  uint8_t event_count = 0;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    Event event = event_controller.getEvent(event_index);
+    if (event.free)
+    {
+      continue;
+    }
+    ++event_count;
+    if (!event.infinite && !event.armed && !batchArmed(event_index))
+    {
+      printf("zombie slot %d: arg %d inc %d count %d enabled %d batched %d\n",
+        event_index,event.arg,event.inc,event.count,event.enabled,event.batched);
+      CHECK(false);
+    }
+  }
+  CHECK_EQUAL(event_count,event_controller.getEventPool().getCount());
+}
+
+void checkTokens()
+{
+  uint32_t lost_stop_count = 0;
+  uint32_t stop_count = 0;
+  uint32_t fire_count = 0;
+  for (uint32_t token=1; token<token_count; ++token)
+  {
+    stop_count += stop_counts[token].load();
+    fire_count += fire_counts[token].load();
+    if (token_stop_attached[token] && !token_cleared[token] && (stop_counts[token].load() != 1))
+    {
+      ++lost_stop_count;
+    }
+  }
+  printf("tokens %u fires %u stops %u\n",token_count - 1,fire_count,stop_count);
+  CHECK_EQUAL(0,lost_stop_count);
+  CHECK_EQUAL(0,double_stop_count.load());
+  CHECK_EQUAL(0,double_fire_count.load());
+  CHECK_EQUAL(0,fire_after_stop_count.load());
+}
+
+int main(int argc,
+  char * argv[])
+{
+  double duration = (argc > 1) ? atof(argv[1]) : 2.0;
+  fire_functor = makeFunctor((Functor1<int> *)0,fireHandler);
+  stop_functor = makeFunctor((Functor1<int> *)0,stopHandler);
+  event_controller.setup();
+  hostAttachInterrupt(EventTimerHost::isr());
+  signal(SIGALRM,interruptSignalHandler);
+  setInterruptTimer(INTERRUPT_PERIOD_US);
+
+  uint64_t op_count = 0;
+  double time_start = secondsNow();
+  double time_end = time_start + duration;
+  while ((token_count < (TOKEN_COUNT_MAX - 8)) && ((op_count & 0xFF) || (secondsNow() < time_end)))
+  {
+    runOp((Op)randomBelow(OP_COUNT));
+    ++op_count;
+  }
+  double elapsed = secondsNow() - time_start;
+  setInterruptTimer(0);
+  signal(SIGALRM,SIG_IGN);
+
+  printf("ops %llu in %.2f s: %.0f ops/s, %u interrupts, %u ticks\n",
+    (unsigned long long)op_count,elapsed,op_count / elapsed,interrupt_count.load(),event_controller.getTicks());
+
+  EventTimerHost::tick(QUIESCE_TICK_COUNT);
+  event_controller.dispatchDeferred();
+  checkQuiescent();
+  event_controller.removeAllEvents();
+  event_controller.dispatchDeferred();
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+  CHECK_EQUAL(0,event_controller.getEventPool().getCount());
+  checkTokens();
+
+  bool allocated[EVENT_COUNT_MAX] = {};
+  uint8_t allocated_count = 0;
+  for (uint8_t event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    EventId event_id = event_controller.addEventUsingDelay(fire_functor,1);
+    if ((event_id.index < EVENT_COUNT_MAX) && !allocated[event_id.index])
+    {
+      allocated[event_id.index] = true;
+      ++allocated_count;
+    }
+  }
+  CHECK_EQUAL(EVENT_COUNT_MAX,allocated_count);
+  CHECK_EQUAL(0,event_controller.eventsAvailable());
+  event_controller.removeAllEvents();
+
+  return HOST_TEST_RESULT("StressTest");
+}
@@ -0,0 +1,156 @@
+// ----------------------------------------------------------------------------
+// TaskTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#define EVENT_TASK_FRAME_SIZE_MAX 512
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=EVENT_TASK_COUNT_MAX};
+enum{STEP_COUNT=3};
+enum{STEP_DELAY=10};
+enum{TASK_REPEAT_COUNT=3 * EVENT_TASK_COUNT_MAX};
+
+typedef EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> Controller;
+Controller event_controller;
+uint32_t step_ticks[EVENT_COUNT_MAX][STEP_COUNT];
+int step_counts[EVENT_COUNT_MAX];
+int finished_count = 0;
+int destroyed_count = 0;
+int continued_count = 0;
+
+struct TaskGuard
+{
+  ~TaskGuard()
+  {
+    ++destroyed_count;
+  }
+};
+
+void dummyHandler(int)
+{
+}
+
+EventTask stepTask(Controller & controller,
+  int task_id)
+{
+  TaskGuard guard;
+  for (int step=0; step<STEP_COUNT; ++step)
+  {
+    step_ticks[task_id][step] = controller.getTicks();
+    ++step_counts[task_id];
+    co_await controller.delay(STEP_DELAY);
+  }
+  ++finished_count;
+}
+
+EventTask removingTask(Controller & controller)
+{
+  TaskGuard guard;
+  controller.removeAllEvents();
+  co_await controller.delay(STEP_DELAY);
+  ++continued_count;
+}
+
+void resetCounts()
+{
+  for (int task_id=0; task_id<EVENT_COUNT_MAX; ++task_id)
+  {
+    step_counts[task_id] = 0;
+  }
+  finished_count = 0;
+  destroyed_count = 0;
+}
+
+int main()
+{
+  event_controller.setup();
+
+  CHECK(stepTask(event_controller,0).valid());
+  CHECK_EQUAL(1,step_counts[0]);
+  CHECK_EQUAL(EVENT_COUNT_MAX - 1,event_controller.eventsAvailable());
+  for (int step=1; step<=STEP_COUNT; ++step)
+  {
+    EventTimerHost::tick(STEP_DELAY);
+    CHECK_EQUAL(step,step_counts[0]);
+    CHECK_EQUAL(1,event_controller.dispatchDeferred());
+  }
+  for (int step=0; step<STEP_COUNT; ++step)
+  {
+    CHECK_EQUAL(step * STEP_DELAY,step_ticks[0][step]);
+  }
+  CHECK_EQUAL(1,finished_count);
+  CHECK_EQUAL(1,destroyed_count);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  resetCounts();
+  Functor1<int> dummy_functor = makeFunctor((Functor1<int> *)0,dummyHandler);
+  for (int event_index=0; event_index<EVENT_COUNT_MAX; ++event_index)
+  {
+    event_controller.addEventUsingDelay(dummy_functor,1000);
+  }
+  for (int repeat=0; repeat<TASK_REPEAT_COUNT; ++repeat)
+  {
+    CHECK(!stepTask(event_controller,0).valid());
+  }
+  CHECK_EQUAL(0,step_counts[0]);
+  CHECK_EQUAL(0,destroyed_count);
+  event_controller.removeAllEvents();
+
+  for (int repeat=0; repeat<TASK_REPEAT_COUNT; ++repeat)
+  {
+    resetCounts();
+    for (int task_id=0; task_id<EVENT_COUNT_MAX; ++task_id)
+    {
+      CHECK(stepTask(event_controller,task_id).valid());
+    }
+    CHECK_EQUAL(0,event_controller.eventsAvailable());
+    if (repeat % 2)
+    {
+      event_controller.setup();
+    }
+    else
+    {
+      event_controller.removeAllEvents();
+    }
+    event_controller.dispatchDeferred();
+    CHECK_EQUAL(EVENT_COUNT_MAX,destroyed_count);
+    CHECK_EQUAL(0,finished_count);
+    CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+  }
+
+  resetCounts();
+  CHECK(stepTask(event_controller,0).valid());
+  EventTimerHost::tick(STEP_DELAY);
+  event_controller.removeAllEvents();
+  CHECK(stepTask(event_controller,1).valid());
+  event_controller.dispatchDeferred();
+  CHECK_EQUAL(1,step_counts[0]);
+  CHECK_EQUAL(1,step_counts[1]);
+  CHECK_EQUAL(1,destroyed_count);
+  EventTimerHost::tick(STEP_DELAY);
+  event_controller.dispatchDeferred();
+  CHECK_EQUAL(2,step_counts[1]);
+  event_controller.removeAllEvents();
+  event_controller.dispatchDeferred();
+  CHECK_EQUAL(2,destroyed_count);
+
+  resetCounts();
+  CHECK(removingTask(event_controller).valid());
+  CHECK_EQUAL(1,destroyed_count);
+  CHECK_EQUAL(0,continued_count);
+  EventTimerHost::tick(STEP_DELAY);
+  event_controller.dispatchDeferred();
+  CHECK_EQUAL(0,continued_count);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  return HOST_TEST_RESULT("TaskTest");
+}
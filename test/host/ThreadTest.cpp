@@ -0,0 +1,174 @@
+// ----------------------------------------------------------------------------
+// ThreadTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include <atomic>
+#include <time.h>
+#include <unistd.h>
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerThread.h"
+#include "EventWorkerPool.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=16};
+enum{WORKER_COUNT=4};
+enum{STREAM_COUNT=6};
+enum{FIRE_COUNT=40};
+enum{TIMEOUT_MS=10000};
+
+EventController<EVENT_COUNT_MAX,200,false,EventTimerThread> event_controller;
+typedef EventWorkerPool<WORKER_COUNT,EVENT_COUNT_MAX> WorkerPool;
+WorkerPool worker_pool;
+
+std::atomic<uint32_t> fire_counts[STREAM_COUNT];
+std::atomic<uint32_t> stop_counts[STREAM_COUNT];
+std::atomic<bool> in_flight[STREAM_COUNT];
+std::atomic<uint32_t> overlap_count(0);
+std::atomic<uint32_t> early_stop_count(0);
+std::atomic<uint32_t> idle_count(0);
+bool serial[STREAM_COUNT];
+
+void fireHandler(int arg)
+{
+  if (serial[arg] && in_flight[arg].exchange(true))
+  {
+    ++overlap_count;
+  }
+  ++fire_counts[arg];
+  if (serial[arg])
+  {
+    in_flight[arg] = false;
+  }
+}
+
+void stopHandler(int arg)
+{
+  if (serial[arg] && (fire_counts[arg] != FIRE_COUNT))
+  {
+    ++early_stop_count;
+  }
+  ++stop_counts[arg];
+}
+
+uint32_t millisNow()
+{
+  timespec time_now;
+  clock_gettime(CLOCK_MONOTONIC,&time_now);
+  return time_now.tv_sec * 1000 + time_now.tv_nsec / 1000000;
+}
+
+bool streamsStopped()
+{
+  for (uint8_t stream=0; stream<STREAM_COUNT; ++stream)
+  {
+    if (stop_counts[stream] == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void idleHandler(int)
+{
+  ++idle_count;
+}
+
+void checkSlotReuse()
+{
+  Functor1<int> idle_functor = makeFunctor((Functor1<int> *)0,idleHandler);
+  EventId stale_id = event_controller.addEventUsingDelay(idle_functor,1000);
+  worker_pool.setSerial(stale_id);
+  worker_pool.setAffinity(stale_id,WORKER_COUNT - 1);
+  CHECK(worker_pool.getSerial(stale_id));
+  CHECK_EQUAL(WORKER_COUNT - 1,worker_pool.getAffinity(stale_id));
+  event_controller.remove(stale_id);
+  uint32_t ticks = event_controller.getTicks();
+  while (event_controller.getTicks() == ticks)
+  {
+    usleep(100);
+  }
+
+  EventId event_id = event_controller.addEventUsingDelay(idle_functor,1000);
+  CHECK_EQUAL(stale_id.index,event_id.index);
+  CHECK(stale_id != event_id);
+  CHECK(!worker_pool.getSerial(event_id));
+  CHECK_EQUAL((uint8_t)WorkerPool::WORKER_NONE,worker_pool.getAffinity(event_id));
+
+  worker_pool.setSerial(event_id);
+  CHECK(worker_pool.getSerial(event_id));
+  CHECK(!worker_pool.getSerial(stale_id));
+  CHECK_EQUAL((uint8_t)WorkerPool::WORKER_NONE,worker_pool.getAffinity(stale_id));
+  CHECK_EQUAL((uint8_t)WorkerPool::WORKER_NONE,worker_pool.getAffinity(event_id));
+
+  worker_pool.post(idle_functor,0,stale_id);
+  worker_pool.post(idle_functor,0,event_id);
+  worker_pool.wait();
+  CHECK_EQUAL(2,idle_count.load());
+  event_controller.remove(event_id);
+}
+
+int main()
+{
+  Functor1<int> fire_functor = makeFunctor((Functor1<int> *)0,fireHandler);
+  Functor1<int> stop_functor = makeFunctor((Functor1<int> *)0,stopHandler);
+  CHECK(worker_pool.start(WORKER_COUNT));
+  event_controller.setup();
+  checkSlotReuse();
+
+  for (uint8_t stream=0; stream<STREAM_COUNT; ++stream)
+  {
+    serial[stream] = (stream % 2) == 0;
+    EventId event_id = event_controller.addRecurringEventUsingDelayMicros(fire_functor,1000,400,FIRE_COUNT,stream);
+    event_controller.addStopFunctor(event_id,stop_functor);
+    event_controller.setDeferred(event_id);
+    worker_pool.setSerial(event_id,serial[stream]);
+    event_controller.enable(event_id);
+  }
+
+  uint32_t time_start = millisNow();
+  while (!streamsStopped() && ((millisNow() - time_start) < TIMEOUT_MS))
+  {
+    event_controller.dispatchDeferred(worker_pool);
+    worker_pool.wait();
+    usleep(100);
+  }
+  EventTimerThread::stop();
+  event_controller.dispatchDeferred(worker_pool);
+  worker_pool.wait();
+
+  uint32_t executed_count = 0;
+  for (uint8_t worker_index=0; worker_index<WORKER_COUNT; ++worker_index)
+  {
+    executed_count += worker_pool.getExecutedCount(worker_index);
+  }
+  worker_pool.stop();
+
+  uint32_t dropped_count = event_controller.getDeferredOverflowCount();
+  for (uint8_t stream=0; stream<STREAM_COUNT; ++stream)
+  {
+    CHECK_EQUAL(1,stop_counts[stream].load());
+    if (dropped_count == 0)
+    {
+      CHECK_EQUAL(FIRE_COUNT,fire_counts[stream].load());
+    }
+  }
+  CHECK_EQUAL(0,overlap_count.load());
+  if (dropped_count == 0)
+  {
+    CHECK_EQUAL(0,early_stop_count.load());
+  }
+  CHECK_EQUAL(STREAM_COUNT * (FIRE_COUNT + 1) - dropped_count,executed_count - idle_count);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+  printf("ticks %u overruns %u dropped %u steals %u\n",
+    event_controller.getTicks(),EventTimerThread::getOverrunCount(),dropped_count,worker_pool.getStealCount());
+
+  return HOST_TEST_RESULT("ThreadTest");
+}
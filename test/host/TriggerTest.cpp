@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------------
+// TriggerTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+enum{TRIGGER_PIN=3};
+enum{TRIGGER_DELAY_US=500};
+enum{TRIGGER_DELAY_TICKS=5};
+enum{ON_DURATION_MS=2};
+enum{ON_DURATION_TICKS=20};
+
+EventController<EVENT_COUNT_MAX,100,false,EventTimerHost> event_controller;
+EventIdPair trigger_pair;
+uint32_t trigger_ticks = 0;
+int trigger_count = 0;
+uint32_t fire_ticks[2];
+int fire_counts[2];
+
+void triggerIsr()
+{
+  trigger_ticks = event_controller.getTicks();
+  ++trigger_count;
+  event_controller.trigger(trigger_pair);
+}
+
+void fireHandler(int arg)
+{
+  fire_ticks[arg] = event_controller.getTicks();
+  ++fire_counts[arg];
+}
+
+void fireOffHandler(int)
+{
+  fireHandler(1);
+}
+
+void resetCounts()
+{
+  trigger_count = 0;
+  fire_counts[0] = 0;
+  fire_counts[1] = 0;
+}
+
+void checkLatency()
+{
+  Functor1<int> fire_functor = makeFunctor((Functor1<int> *)0,fireHandler);
+  resetCounts();
+  trigger_pair.event_id_0 = event_controller.addEventUsingDelay(fire_functor,1,0);
+  trigger_pair.event_id_1 = EventId();
+  event_controller.armUsingDelayMicros(trigger_pair,TRIGGER_DELAY_US);
+  event_controller.enable(trigger_pair);
+
+  EventTimerHost::tick(37);
+  CHECK_EQUAL(0,fire_counts[0]);
+  hostDriveInput(TRIGGER_PIN,HIGH);
+  CHECK_EQUAL(1,trigger_count);
+  EventTimerHost::tick(TRIGGER_DELAY_TICKS - 1);
+  CHECK_EQUAL(0,fire_counts[0]);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(1,fire_counts[0]);
+  CHECK_EQUAL(TRIGGER_DELAY_TICKS,fire_ticks[0] - trigger_ticks);
+
+  hostDriveInput(TRIGGER_PIN,LOW);
+  CHECK_EQUAL(1,trigger_count);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+}
+
+void checkMaskedEdge()
+{
+  Functor1<int> fire_functor = makeFunctor((Functor1<int> *)0,fireHandler);
+  resetCounts();
+  trigger_pair.event_id_0 = event_controller.addEventUsingDelay(fire_functor,1,0);
+  trigger_pair.event_id_1 = EventId();
+  event_controller.armUsingDelayMicros(trigger_pair,TRIGGER_DELAY_US);
+  event_controller.enable(trigger_pair);
+
+  noInterrupts();
+  hostDriveInput(TRIGGER_PIN,HIGH);
+  CHECK_EQUAL(0,trigger_count);
+  interrupts();
+  CHECK_EQUAL(1,trigger_count);
+  EventTimerHost::tick(TRIGGER_DELAY_TICKS);
+  CHECK_EQUAL(1,fire_counts[0]);
+  CHECK_EQUAL(TRIGGER_DELAY_TICKS,fire_ticks[0] - trigger_ticks);
+  hostDriveInput(TRIGGER_PIN,LOW);
+}
+
+void checkPair()
+{
+  Functor1<int> fire_functor_0 = makeFunctor((Functor1<int> *)0,fireHandler);
+  Functor1<int> fire_functor_1 = makeFunctor((Functor1<int> *)0,fireOffHandler);
+  resetCounts();
+  trigger_pair = event_controller.addPwmUsingDelay(fire_functor_0,fire_functor_1,1,100,ON_DURATION_MS,1,0);
+  Event event_0 = event_controller.getEvent(trigger_pair.event_id_0);
+  Event event_1 = event_controller.getEvent(trigger_pair.event_id_1);
+  CHECK_EQUAL(ON_DURATION_TICKS,event_1.time - event_0.time);
+  event_controller.armUsingDelayMicros(trigger_pair,TRIGGER_DELAY_US);
+  event_controller.enable(trigger_pair);
+
+  EventTimerHost::tick(50);
+  CHECK_EQUAL(0,fire_counts[0] + fire_counts[1]);
+  hostDriveInput(TRIGGER_PIN,HIGH);
+  EventTimerHost::tick(TRIGGER_DELAY_TICKS);
+  EventTimerHost::tick(ON_DURATION_TICKS);
+  CHECK_EQUAL(2,fire_counts[0] + fire_counts[1]);
+  CHECK_EQUAL(ON_DURATION_TICKS,fire_ticks[1] - fire_ticks[0]);
+  CHECK_EQUAL(TRIGGER_DELAY_TICKS,fire_ticks[0] - trigger_ticks);
+  hostDriveInput(TRIGGER_PIN,LOW);
+  event_controller.remove(trigger_pair);
+}
+
+void checkStalePair()
+{
+  Functor1<int> fire_functor = makeFunctor((Functor1<int> *)0,fireHandler);
+  resetCounts();
+  EventIdPair stale_pair = event_controller.addPwmUsingDelay(fire_functor,fire_functor,1000,100,ON_DURATION_MS,1);
+  event_controller.remove(stale_pair);
+  EventTimerHost::tick(1);
+  EventIdPair event_id_pair = event_controller.addPwmUsingDelay(fire_functor,fire_functor,1000,100,ON_DURATION_MS,1);
+  CHECK_EQUAL(stale_pair.event_id_1.index,event_id_pair.event_id_0.index);
+  CHECK_EQUAL(stale_pair.event_id_0.index,event_id_pair.event_id_1.index);
+  event_controller.armUsingDelayMicros(stale_pair,TRIGGER_DELAY_US);
+  CHECK(!event_controller.getEvent(event_id_pair.event_id_0).armed);
+  CHECK(!event_controller.getEvent(event_id_pair.event_id_1).armed);
+  CHECK_EQUAL(0,event_controller.getEvent(event_id_pair.event_id_1).trigger_delay);
+  event_controller.remove(event_id_pair);
+
+  EventIdPair mixed_pair;
+  mixed_pair.event_id_0 = event_controller.addEventUsingDelay(fire_functor,1000,0);
+  mixed_pair.event_id_1 = event_controller.addEventUsingDelay(fire_functor,1000,0);
+  event_controller.remove(mixed_pair.event_id_0);
+  event_controller.armUsingDelayMicros(mixed_pair,TRIGGER_DELAY_US);
+  CHECK(!event_controller.getEvent(mixed_pair.event_id_1).armed);
+  CHECK_EQUAL(0,event_controller.getEvent(mixed_pair.event_id_1).trigger_delay);
+  event_controller.remove(mixed_pair);
+}
+
+int main()
+{
+  event_controller.setup();
+  attachInterrupt(digitalPinToInterrupt(TRIGGER_PIN),triggerIsr,RISING);
+
+  checkLatency();
+  checkMaskedEdge();
+  checkPair();
+  checkStalePair();
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  detachInterrupt(digitalPinToInterrupt(TRIGGER_PIN));
+  return HOST_TEST_RESULT("TriggerTest");
+}
@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------
+// WorkerPoolBenchmark.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include <stdlib.h>
+#include <time.h>
+#include <thread>
+#include "EventWorkerPool.h"
+
+
+enum{EVENT_COUNT_MAX=32};
+enum{WORKER_COUNT_MAX=16};
+enum{TASK_COUNT=20000};
+enum{SPIN_COUNT=20000};
+
+EventWorkerPool<WORKER_COUNT_MAX,EVENT_COUNT_MAX> worker_pool;
+
+double secondsNow()
+{
+  timespec time_now;
+  clock_gettime(CLOCK_MONOTONIC,&time_now);
+  return time_now.tv_sec + time_now.tv_nsec * 1e-9;
+}
+
+void spinHandler(int arg)
+{
+  volatile uint32_t value = arg;
+  for (uint32_t spin=0; spin<SPIN_COUNT; ++spin)
+  {
+    value = value * 1664525 + 1013904223;
+  }
+}
+
+int main(int argc,
+  char * argv[])
+{
+  uint8_t serial_event_count = (argc > 1) ? atoi(argv[1]) : 0;
+  Functor1<int> spin_functor = makeFunctor((Functor1<int> *)0,spinHandler);
+  for (uint8_t event_index=0; event_index<serial_event_count; ++event_index)
+  {
+    EventId event_id;
+    event_id.index = event_index;
+    worker_pool.setSerial(event_id);
+  }
+  printf("hardware threads %u, tasks %u, serial events %u of %u\n",
+    std::thread::hardware_concurrency(),TASK_COUNT,serial_event_count,EVENT_COUNT_MAX);
+  double throughput_single = 0;
+  for (uint8_t worker_count=1; worker_count<=WORKER_COUNT_MAX; worker_count*=2)
+  {
+    worker_pool.start(worker_count);
+    double time_start = secondsNow();
+    for (uint32_t task=0; task<TASK_COUNT; ++task)
+    {
+      EventId event_id;
+      event_id.index = task % EVENT_COUNT_MAX;
+      worker_pool.post(spin_functor,task,event_id);
+    }
+    worker_pool.wait();
+    double elapsed = secondsNow() - time_start;
+    uint32_t steal_count = worker_pool.getStealCount();
+    worker_pool.stop();
+    double throughput = TASK_COUNT / elapsed;
+    if (worker_count == 1)
+    {
+      throughput_single = throughput;
+    }
+    printf("workers %2u: %9.0f tasks/s, speedup %5.2f, steals %u\n",
+      worker_count,throughput,throughput / throughput_single,steal_count);
+  }
+  return 0;
+}
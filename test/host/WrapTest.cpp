@@ -0,0 +1,111 @@
+// ----------------------------------------------------------------------------
+// WrapTest.cpp
+//
+//
+// Authors:
+// Peter Polidoro peter@polidoro.io
+// ----------------------------------------------------------------------------
+#define EVENT_CONTROLLER_NO_RUNTIME_TIMER
+#include "HostTest.h"
+#include "EventController.h"
+#include "EventTimerHost.h"
+
+
+HOST_TEST_DEFINE;
+
+enum{EVENT_COUNT_MAX=8};
+
+EventController<EVENT_COUNT_MAX,1000,false,EventTimerHost> event_controller;
+EventController<EVENT_COUNT_MAX,100,false,EventTimerHost> event_controller_fast;
+int functor_count = 0;
+int recurring_count = 0;
+uint32_t recurring_ticks[8];
+
+void countHandler(int)
+{
+  ++functor_count;
+}
+
+void recurringHandler(int)
+{
+  if (recurring_count < 8)
+  {
+    recurring_ticks[recurring_count] = event_controller.getTicks();
+  }
+  ++recurring_count;
+}
+
+void checkWrapMillis()
+{
+  Functor1<int> count_functor = makeFunctor((Functor1<int> *)0,countHandler);
+  Functor1<int> recurring_functor = makeFunctor((Functor1<int> *)0,recurringHandler);
+  event_controller.setup();
+
+  event_controller.setTime(0xFFFFFFFF - 9);
+  CHECK_EQUAL(0xFFFFFFF6,event_controller.getTicks());
+  EventId event_id = event_controller.addEventUsingDelay(count_functor,20);
+  event_controller.enable(event_id);
+  EventId recurring = event_controller.addRecurringEventUsingDelay(recurring_functor,3,7,5);
+  event_controller.enable(recurring);
+  EventTimerHost::tick(19);
+  CHECK_EQUAL(0,functor_count);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(1,functor_count);
+  EventTimerHost::tick(40);
+  CHECK_EQUAL(5,recurring_count);
+  for (uint8_t index=0; index<5; ++index)
+  {
+    CHECK_EQUAL((uint32_t)(0xFFFFFFF9 + 7 * index),recurring_ticks[index]);
+  }
+  CHECK_EQUAL(EVENT_COUNT_MAX,event_controller.eventsAvailable());
+
+  event_controller.setTime(100);
+  event_id = event_controller.addEventUsingDelay(count_functor,10);
+  event_controller.enable(event_id);
+  event_controller.rebaseTime(0xFFFFFFFF - 4);
+  EventTimerHost::tick(9);
+  CHECK_EQUAL(1,functor_count);
+  EventTimerHost::tick(1);
+  CHECK_EQUAL(2,functor_count);
+
+  EventId far = event_controller.addEventUsingDelay(count_functor,0x7FFFFFFF - 10);
+  CHECK(far.index < EVENT_COUNT_MAX);
+  EventId beyond = event_controller.addEventUsingOffset(count_functor,far,20);
+  CHECK(beyond.index >= EVENT_COUNT_MAX);
+  EventId within = event_controller.addEventUsingOffset(count_functor,far,5);
+  CHECK(within.index < EVENT_COUNT_MAX);
+  event_controller.removeAllEvents();
+}
+
+void checkWrapMicros()
+{
+  Functor1<int> count_functor = makeFunctor((Functor1<int> *)0,countHandler);
+  event_controller_fast.setup();
+  functor_count = 0;
+
+  event_controller_fast.setTime(429496729);
+  CHECK_EQUAL(0xFFFFFFFA,event_controller_fast.getTicks());
+  uint32_t time_before = event_controller_fast.getTime();
+  EventTimerHost::tick(20);
+  CHECK_EQUAL(time_before + 2,event_controller_fast.getTime());
+
+  EventId event_id = event_controller_fast.addEventUsingDelay(count_functor,0xFFFFFFFF);
+  event_controller_fast.enable(event_id);
+  Event event = event_controller_fast.getEvent(event_id);
+  CHECK_EQUAL(0x7FFFFFFF,(uint32_t)(event.time - event_controller_fast.getTicks()));
+  EventTimerHost::tick(1000);
+  CHECK_EQUAL(0,functor_count);
+
+  EventId timeout = event_controller_fast.addTimeout(count_functor,0xFFFFFFFF);
+  event = event_controller_fast.getEvent(timeout);
+  CHECK_EQUAL(0x7FFFFFFF,(uint32_t)(event.time - event_controller_fast.getTicks()));
+  event_controller_fast.removeAllEvents();
+}
+
+int main()
+{
+  checkWrapMillis();
+  checkWrapMicros();
+
+  return HOST_TEST_RESULT("WrapTest");
+}